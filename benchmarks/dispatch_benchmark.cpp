@@ -0,0 +1,88 @@
+#include "exios/exios.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+/* Measures the cost of creating and dispatching operations, without any
+ * I/O, along with the size of their common headers. Usage:
+ *
+ *   dispatch_benchmark [num_operations]
+ */
+
+namespace
+{
+constexpr std::size_t kBatchSize = 1024;
+
+template <typename F>
+auto measure(std::string_view name, std::size_t num_operations, F&& f) -> void
+{
+    auto const start = std::chrono::steady_clock::now();
+    f();
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+
+    auto const nanoseconds =
+        std::chrono::duration<double, std::nano>(elapsed).count();
+    std::cout << name << ": "
+              << nanoseconds / static_cast<double>(num_operations)
+              << "ns per operation\n";
+}
+
+auto posted_work(std::size_t num_operations) -> void
+{
+    exios::ContextThread thread;
+    std::size_t count = 0;
+
+    measure("post + dispatch", num_operations, [&] {
+        for (std::size_t i = 0; i < num_operations; i += kBatchSize) {
+            for (std::size_t j = 0; j < kBatchSize; ++j)
+                thread.post([&] { count += 1; });
+
+            static_cast<void>(thread.run());
+        }
+    });
+}
+
+auto io_operations(std::size_t num_operations) -> void
+{
+    exios::ContextThread thread;
+    std::size_t count = 0;
+    char buffer[1];
+
+    /* Cancelled operations are completed without touching the FD, so
+     * this is just the cost of the operation's machinery...
+     */
+    measure("io operation create + cancel + dispatch", num_operations, [&] {
+        for (std::size_t i = 0; i < num_operations; ++i) {
+            auto* op = exios::make_async_io_operation(
+                exios::read_operation,
+                [&](exios::IoResult) { count += 1; },
+                thread.get_allocator(),
+                thread,
+                -1,
+                exios::BufferView { buffer, sizeof(buffer) });
+
+            op->cancel();
+            exios::dispatch(std::move(*op));
+        }
+    });
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+    std::size_t const num_operations =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+    std::cout << "sizeof(AnyAsyncOperation): "
+              << sizeof(exios::AnyAsyncOperation)
+              << "\nsizeof(AsyncIoOperation): "
+              << sizeof(exios::AsyncIoOperation) << '\n';
+
+    posted_work(num_operations);
+    io_operations(num_operations);
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include "exios/exios.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Measures the round trip rate of a number of concurrent ping-pong
+ * exchanges over Unix sockets, for each of the I/O backends. Usage:
+ *
+ *   io_backend_benchmark [num_pairs] [num_round_trips]
+ */
+
+namespace
+{
+constexpr std::size_t kMessageSize = 64;
+
+struct Pair
+{
+    explicit Pair(exios::ContextThread& thread, std::string abstract_name)
+        : acceptor { thread, abstract_name }
+        , client { thread }
+        , server { thread }
+        , name { std::move(abstract_name) }
+    {
+    }
+
+    exios::UnixSocketAcceptor acceptor;
+    exios::UnixSocket client;
+    exios::UnixSocket server;
+    std::string name;
+    std::array<char, kMessageSize> client_buffer {};
+    std::array<char, kMessageSize> server_buffer {};
+    std::size_t remaining { 0 };
+};
+
+auto echo(Pair& pair) -> void
+{
+    pair.server.read(
+        exios::BufferView { pair.server_buffer.data(),
+                            pair.server_buffer.size() },
+        [&pair](exios::IoResult result) {
+            if (!result || result.value() == 0)
+                return;
+
+            pair.server.write(
+                exios::ConstBufferView { pair.server_buffer.data(),
+                                         result.value() },
+                [&pair](exios::IoResult write_result) {
+                    if (write_result)
+                        echo(pair);
+                });
+        });
+}
+
+auto ping(Pair& pair) -> void
+{
+    if (pair.remaining == 0) {
+        pair.client.close();
+        return;
+    }
+
+    pair.remaining -= 1;
+    pair.client.write(
+        exios::ConstBufferView { pair.client_buffer.data(),
+                                 pair.client_buffer.size() },
+        [&pair](exios::IoResult result) {
+            if (!result)
+                return;
+
+            pair.client.read(
+                exios::BufferView { pair.client_buffer.data(),
+                                    pair.client_buffer.size() },
+                [&pair](exios::IoResult read_result) {
+                    if (read_result)
+                        ping(pair);
+                });
+        });
+}
+
+auto run(exios::IoBackend backend,
+         std::string_view backend_name,
+         std::size_t num_pairs,
+         std::size_t num_round_trips) -> void
+{
+    exios::ContextThread thread { backend };
+    std::vector<std::unique_ptr<Pair>> pairs;
+
+    for (std::size_t i = 0; i < num_pairs; ++i) {
+        auto name = "exios_benchmark_" + std::string { backend_name } + "_" +
+                    std::to_string(i);
+        auto& pair =
+            *pairs.emplace_back(std::make_unique<Pair>(thread, name));
+        pair.remaining = num_round_trips;
+
+        pair.acceptor.accept(pair.server, [&pair](auto const& result) {
+            if (result)
+                echo(pair);
+        });
+
+        pair.client.connect(pair.name, [&pair](auto const& result) {
+            if (result)
+                ping(pair);
+        });
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    static_cast<void>(thread.run());
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+
+    auto const seconds = std::chrono::duration<double>(elapsed).count();
+    auto const total = static_cast<double>(num_pairs * num_round_trips);
+    std::cout << backend_name << ": " << total << " round trips in " << seconds
+              << "s (" << static_cast<std::size_t>(total / seconds)
+              << " per second)\n";
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+    std::size_t const num_pairs =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    std::size_t const num_round_trips =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10'000;
+
+    run(exios::IoBackend::epoll, "epoll", num_pairs, num_round_trips);
+
+    if (exios::IoUring::is_supported())
+        run(exios::IoBackend::io_uring, "io_uring", num_pairs, num_round_trips);
+    else
+        std::cout << "io_uring: not supported\n";
+
+    return 0;
+}
@@ -40,5 +40,21 @@ function(make_test)
         ${MAKE_TEST_NAME}
         PROPERTIES
             TIMEOUT ${MAKE_TEST_TIMEOUT}
+            RESOURCE_LOCK ${MAKE_TEST_NAME}
     )
+
+    # Run the same test again against the io_uring backend...
+    if(EXIOS_ENABLE_IO_URING_TESTS)
+        add_test(
+            NAME ${MAKE_TEST_NAME}_io_uring
+            COMMAND ${MAKE_TEST_NAME}
+        )
+        set_tests_properties(
+            ${MAKE_TEST_NAME}_io_uring
+            PROPERTIES
+                ENVIRONMENT "${MAKE_TEST_ENV_VARS};EXIOS_IO_BACKEND=io_uring"
+                TIMEOUT ${MAKE_TEST_TIMEOUT}
+                RESOURCE_LOCK ${MAKE_TEST_NAME}
+        )
+    endif()
 endfunction()
@@ -1,7 +1,9 @@
 #ifndef EXIOS_ALLOC_UTILS_HPP_INCLUDED
 #define EXIOS_ALLOC_UTILS_HPP_INCLUDED
 
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
 #include <type_traits>
 #include <utility>
 
@@ -15,13 +17,38 @@ concept HasMemberAllocator = requires (T val) {
 };
 // clang-format on
 
+template <typename T>
+concept MemoryResourcePointer =
+    std::is_pointer_v<T> &&
+    std::is_convertible_v<T, std::pmr::memory_resource*>;
+
+/*!
+ * Allows a `std::pmr::memory_resource*` to be used anywhere an allocator is
+ * expected, by wrapping it in a `std::pmr::polymorphic_allocator`. Other
+ * allocators are returned unchanged.
+ */
+template <typename Alloc>
+auto as_allocator(Alloc const& alloc) -> Alloc const&
+requires(!MemoryResourcePointer<Alloc>)
+{
+    return alloc;
+}
+
+template <MemoryResourcePointer Resource>
+auto as_allocator(Resource resource) noexcept
+    -> std::pmr::polymorphic_allocator<std::byte>
+{
+    return std::pmr::polymorphic_allocator<std::byte> { resource };
+}
+
 template <typename T, typename Alloc>
 auto rebind_allocator(Alloc const& alloc)
 {
-    using ReboundAlloc =
-        std::allocator_traits<Alloc>::template rebind_alloc<std::decay_t<T>>;
+    using Normalized = std::decay_t<decltype(as_allocator(alloc))>;
+    using ReboundAlloc = std::allocator_traits<
+        Normalized>::template rebind_alloc<std::decay_t<T>>;
 
-    return ReboundAlloc { alloc };
+    return ReboundAlloc { as_allocator(alloc) };
 }
 
 template <HasMemberAllocator F, typename Alloc = std::allocator<void>>
@@ -76,10 +103,15 @@ private:
 
 } // namespace detail
 
+/*!
+ * Binds an allocator, or a `std::pmr::memory_resource*`, to `f`. Any
+ * operation that `f` is passed to as a completion will allocate from it.
+ */
 template <typename F, typename Alloc>
 auto use_allocator(F&& f, Alloc const& alloc)
 {
-    return detail::UseAllocatorWrapper { std::forward<F>(f), alloc };
+    return detail::UseAllocatorWrapper { std::forward<F>(f),
+                                         as_allocator(alloc) };
 }
 
 } // namespace exios
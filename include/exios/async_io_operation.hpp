@@ -5,59 +5,129 @@
 #include "exios/buffer_view.hpp"
 #include "exios/context.hpp"
 #include "exios/io.hpp"
-#include <system_error>
+#include <cstdint>
 #include <type_traits>
 
 namespace exios
 {
+/*!
+ * The common header of every I/O operation. The I/O actions are performed
+ * by the same thunk as `dispatch()` and `discard()`.
+ */
 struct AsyncIoOperation : AnyAsyncOperation
 {
-    using ResultType = std::size_t;
-    using ErrorType = std::error_code;
+    AsyncIoOperation(Thunk thunk,
+                     Context ctx,
+                     int fd,
+                     bool is_read_operation,
+                     bool is_error_queue_operation = false) noexcept;
 
-    AsyncIoOperation(Context ctx, int fd, bool is_read_operation) noexcept;
+    [[nodiscard]] auto perform_io() noexcept -> bool
+    {
+        return perform(OperationAction::perform_io);
+    }
+
+    /* Used by the io_uring backend in place of `perform_io()`; The
+     * operation is described by a submission and the result of that
+     * submission is passed to `complete_submission()`...
+     */
+    auto prepare_submission(io_uring_sqe& sqe) noexcept -> void
+    {
+        static_cast<void>(perform(OperationAction::prepare_submission, &sqe));
+    }
+
+    [[nodiscard]] auto complete_submission(int res) noexcept -> bool
+    {
+        return perform(OperationAction::complete_submission, &res);
+    }
+
+    /* Gives the operation `error` as its result, as if its I/O had
+     * failed, for when it can't be queued at all...
+     */
+    auto fail(int error) noexcept -> void;
 
-    [[nodiscard]] virtual auto perform_io() noexcept -> bool = 0;
     auto cancel() noexcept -> void;
+
+    /* Marks the operation as cancelled without giving it a result yet;
+     * For an operation the kernel is still performing, which may finish
+     * it regardless...
+     */
+    auto request_cancel() noexcept -> void;
     [[nodiscard]] auto cancelled() const noexcept -> bool;
     [[nodiscard]] auto get_context() noexcept -> Context&;
     [[nodiscard]] auto get_fd() const noexcept -> int;
     [[nodiscard]] auto is_read_operation() const noexcept -> bool;
 
+    /* Operations that wait on the FD's error queue (e.g. for `MSG_ZEROCOPY`
+     * notifications) are queued separately from reads and writes, and are
+     * woken by `EPOLLERR`...
+     */
+    [[nodiscard]] auto is_error_queue_operation() const noexcept -> bool;
+
 protected:
-    virtual auto do_cancel() noexcept -> void = 0;
-    std::optional<Result<ResultType, ErrorType>> result_;
+    ~AsyncIoOperation() = default;
 
 private:
+    static constexpr std::uint8_t kRead = 1 << 0;
+    static constexpr std::uint8_t kCancelled = 1 << 1;
+    static constexpr std::uint8_t kErrorQueue = 1 << 2;
+
     Context ctx_;
     int fd_;
-    bool is_read_;
-    bool is_cancelled_;
+    std::uint8_t flags_;
 };
 
 template <typename OperationTag, typename F, typename Alloc>
-struct AsyncIoOperationImpl : AsyncIoOperation
+struct AsyncIoOperationImpl final : AsyncIoOperation
 {
     using Operation = IoOperationType<OperationTag>;
 
     template <typename... Args>
     AsyncIoOperationImpl(
         F&& f, Alloc const& alloc, Context ctx, int fd, Args&&... args) noexcept
-        : AsyncIoOperation { ctx, fd, Operation::is_readable }
+        : AsyncIoOperation {
+            &AsyncIoOperationImpl::thunk,
+            ctx,
+            fd,
+            Operation::is_readable,
+            waits_for_error_queue<Operation>
+        }
         , f_ { std::move(f) }
         , alloc_ { alloc }
         , operation_ { std::forward<Args>(args)... }
     {
     }
 
-    [[nodiscard]] auto perform_io() noexcept -> bool override
+private:
+    static auto thunk(AnyAsyncOperation& op, OperationAction action, void* arg)
+        -> bool
     {
-        return operation_.io(get_fd());
+        auto& self = static_cast<AsyncIoOperationImpl&>(op);
+
+        switch (action) {
+        case OperationAction::dispatch:
+            self.invoke();
+            break;
+        case OperationAction::discard:
+            self.destroy();
+            break;
+        case OperationAction::perform_io:
+            return self.operation_.io(self.get_fd());
+        case OperationAction::prepare_submission:
+            self.operation_.prepare(self.get_fd(),
+                                    *static_cast<io_uring_sqe*>(arg));
+            break;
+        case OperationAction::complete_submission:
+            return self.operation_.complete(*static_cast<int*>(arg));
+        case OperationAction::cancel:
+            self.operation_.cancel();
+            break;
+        }
+
+        return true;
     }
 
-    auto do_cancel() noexcept -> void override { operation_.cancel(); }
-
-    auto discard() noexcept -> void override
+    auto destroy() noexcept -> void
     {
         using Self = AsyncIoOperationImpl;
         using SelfAlloc =
@@ -67,15 +137,14 @@ struct AsyncIoOperationImpl : AsyncIoOperation
         alloc_tmp.deallocate(this, 1);
     }
 
-    auto dispatch() -> void override
+    auto invoke() -> void
     {
         auto f { std::move(f_) };
         auto operation { std::move(operation_) };
-        this->discard();
+        destroy();
         std::move(operation).dispatch(std::move(f));
     }
 
-private:
     F f_;
     Alloc alloc_;
     Operation operation_;
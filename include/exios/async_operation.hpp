@@ -1,8 +1,10 @@
 #ifndef EXIOS_ASYNC_OPERATION_HPP_INCLUDED
 #define EXIOS_ASYNC_OPERATION_HPP_INCLUDED
 
+#include "exios/alloc_utils.hpp"
 #include "exios/intrusive_list.hpp"
 #include "exios/result.hpp"
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <system_error>
@@ -12,11 +14,62 @@
 namespace exios
 {
 
+/*!
+ * What an operation's thunk is being asked to do. The I/O actions only
+ * apply to ::exios::AsyncIoOperation.
+ */
+enum class OperationAction : std::uint8_t
+{
+    dispatch,
+    discard,
+    perform_io,
+    prepare_submission,
+    complete_submission,
+    cancel,
+};
+
+/*!
+ * The common header of every operation.
+ *
+ * Rather than a vtable, each operation carries a single thunk that
+ * performs an ::exios::OperationAction on it. `arg` carries the action's
+ * argument, if it has one, and the result is only meaningful for actions
+ * that produce one.
+ */
 struct AnyAsyncOperation : ListItemBase
 {
-    virtual ~AnyAsyncOperation() {}
-    virtual auto dispatch() -> void = 0;
-    virtual auto discard() noexcept -> void = 0;
+    using Thunk = auto (*)(AnyAsyncOperation& op,
+                           OperationAction action,
+                           void* arg) -> bool;
+
+    explicit AnyAsyncOperation(Thunk thunk) noexcept
+        : thunk_ { thunk }
+    {
+    }
+
+    AnyAsyncOperation(AnyAsyncOperation const&) = delete;
+    auto operator=(AnyAsyncOperation const&) -> AnyAsyncOperation& = delete;
+
+    auto dispatch() -> void
+    {
+        static_cast<void>(thunk_(*this, OperationAction::dispatch, nullptr));
+    }
+
+    auto discard() noexcept -> void
+    {
+        static_cast<void>(thunk_(*this, OperationAction::discard, nullptr));
+    }
+
+protected:
+    ~AnyAsyncOperation() = default;
+
+    auto perform(OperationAction action, void* arg = nullptr) -> bool
+    {
+        return thunk_(*this, action, arg);
+    }
+
+private:
+    Thunk thunk_;
 };
 
 template <typename F, typename Alloc>
@@ -24,31 +77,49 @@ struct AsyncOperationImpl final : AnyAsyncOperation
 {
     AsyncOperationImpl(F&& f, Alloc const& alloc);
 
-    auto dispatch() -> void override;
-    auto discard() noexcept -> void override;
+private:
+    static auto thunk(AnyAsyncOperation& op, OperationAction action, void*)
+        -> bool;
+
+    auto invoke() -> void;
+    auto destroy() noexcept -> void;
 
-protected:
     F f_;
     Alloc alloc_;
 };
 
 template <typename F, typename Alloc>
 AsyncOperationImpl<F, Alloc>::AsyncOperationImpl(F&& f, Alloc const& alloc)
-    : f_ { std::forward<F>(f) }
+    : AnyAsyncOperation { &AsyncOperationImpl::thunk }
+    , f_ { std::forward<F>(f) }
     , alloc_ { alloc }
 {
 }
 
 template <typename F, typename Alloc>
-auto AsyncOperationImpl<F, Alloc>::dispatch() -> void
+auto AsyncOperationImpl<F, Alloc>::thunk(AnyAsyncOperation& op,
+                                         OperationAction action,
+                                         void*) -> bool
+{
+    auto& self = static_cast<AsyncOperationImpl&>(op);
+    if (action == OperationAction::dispatch)
+        self.invoke();
+    else
+        self.destroy();
+
+    return true;
+}
+
+template <typename F, typename Alloc>
+auto AsyncOperationImpl<F, Alloc>::invoke() -> void
 {
     auto tmp_f_ { std::move(f_) };
-    discard();
+    destroy();
     tmp_f_();
 }
 
 template <typename F, typename Alloc>
-auto AsyncOperationImpl<F, Alloc>::discard() noexcept -> void
+auto AsyncOperationImpl<F, Alloc>::destroy() noexcept -> void
 {
     using Self = AsyncOperationImpl<F, Alloc>;
     using SelfAlloc = std::allocator_traits<Alloc>::template rebind_alloc<Self>;
@@ -60,6 +131,7 @@ auto AsyncOperationImpl<F, Alloc>::discard() noexcept -> void
 template <typename F, typename Alloc>
 [[nodiscard]] auto make_async_operation(F&& f, Alloc const& alloc)
     -> std::add_pointer_t<AsyncOperationImpl<std::decay_t<F>, Alloc>>
+requires(!MemoryResourcePointer<Alloc>)
 {
     using Self = AsyncOperationImpl<F, Alloc>;
     using SelfAlloc = std::allocator_traits<Alloc>::template rebind_alloc<Self>;
@@ -78,6 +150,12 @@ template <typename F, typename Alloc>
     return ptr;
 }
 
+template <typename F, MemoryResourcePointer Resource>
+[[nodiscard]] auto make_async_operation(F&& f, Resource resource)
+{
+    return make_async_operation(std::forward<F>(f), as_allocator(resource));
+}
+
 auto discard(AnyAsyncOperation&& op) noexcept -> void;
 auto dispatch(AnyAsyncOperation&& op) -> void;
 
@@ -0,0 +1,77 @@
+#ifndef EXIOS_ATOMIC_INTRUSIVE_LIST_HPP_INCLUDED
+#define EXIOS_ATOMIC_INTRUSIVE_LIST_HPP_INCLUDED
+
+#include "exios/intrusive_list.hpp"
+#include <atomic>
+#include <type_traits>
+
+namespace exios
+{
+
+/*!
+ * A lock-free list of intrusive items. Any number of threads can push
+ * items concurrently, and consumers take every item at once with a single
+ * atomic exchange. While an item is in the list only its `next` link is
+ * used.
+ */
+template <ListItem T>
+requires(!std::is_reference_v<T>)
+struct AtomicIntrusiveList
+{
+    AtomicIntrusiveList() noexcept = default;
+
+    AtomicIntrusiveList(AtomicIntrusiveList const&) = delete;
+    auto operator=(AtomicIntrusiveList const&)
+        -> AtomicIntrusiveList& = delete;
+
+    /*!
+     * Pushes `item` onto the list, returning `true` if the list was
+     * empty beforehand.
+     */
+    auto push_back(T* item) noexcept -> bool
+    {
+        ListItemBase* node = item;
+        node->prev = nullptr;
+
+        auto* head = head_.load(std::memory_order_relaxed);
+        do {
+            node->next = head;
+        }
+        while (!head_.compare_exchange_weak(head, node));
+
+        return head == nullptr;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return head_.load() == nullptr;
+    }
+
+    /*!
+     * Removes every item from the list, returning them in the order they
+     * were pushed.
+     */
+    [[nodiscard]] auto take_all() noexcept -> IntrusiveList<T>
+    {
+        IntrusiveList<T> items;
+
+        /* Items are linked newest first, so pushing each one to the
+         * front of `items` restores the order they were pushed in...
+         */
+        auto* node = head_.exchange(nullptr);
+        while (node != nullptr) {
+            auto* next = node->next;
+            items.push_front(static_cast<T*>(node));
+            node = next;
+        }
+
+        return items;
+    }
+
+private:
+    std::atomic<ListItemBase*> head_ { nullptr };
+};
+
+} // namespace exios
+
+#endif // EXIOS_ATOMIC_INTRUSIVE_LIST_HPP_INCLUDED
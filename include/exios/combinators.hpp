@@ -0,0 +1,362 @@
+#ifndef EXIOS_COMBINATORS_HPP_INCLUDED
+#define EXIOS_COMBINATORS_HPP_INCLUDED
+
+#include "exios/alloc_utils.hpp"
+#include "exios/async_operation.hpp"
+#include "exios/context.hpp"
+#include "exios/io_object.hpp"
+#include "exios/work.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace exios
+{
+
+/*!
+ * An operation that hasn't been started yet, for use with
+ * ::exios::when_all and ::exios::when_any.
+ *
+ * `initiate` is called with a completion handler, and should start the
+ * operation on `object` with it. The operation completes with a `T`.
+ */
+template <typename T, typename Initiate>
+struct DeferredOperation
+{
+    using ResultType = T;
+
+    IoObject* object;
+    Initiate initiate;
+};
+
+template <typename T>
+concept IsDeferredOperation = requires(T& op) {
+    typename T::ResultType;
+    { op.object } -> std::convertible_to<IoObject*>;
+};
+
+/*!
+ * Creates an ::exios::DeferredOperation on `object`.
+ *
+ * ```
+ * auto read = exios::defer<exios::IoResult>(socket, [&](auto f) {
+ *     socket.read(exios::BufferView { buf.data(), buf.size() }, std::move(f));
+ * });
+ * ```
+ */
+template <typename T, typename Initiate>
+[[nodiscard]] auto defer(IoObject& object, Initiate&& initiate)
+    -> DeferredOperation<T, std::decay_t<Initiate>>
+{
+    return DeferredOperation<T, std::decay_t<Initiate>> {
+        &object, std::forward<Initiate>(initiate)
+    };
+}
+
+namespace detail
+{
+
+/* Passed to each of the composed operations; Reports its result to the
+ * shared state...
+ */
+template <typename State, std::size_t I>
+struct ComposedCompletion
+{
+    template <typename R>
+    auto operator()(R&& result) -> void
+    {
+        state->template complete<I>(std::forward<R>(result));
+    }
+
+    State* state;
+};
+
+/* The state shared by every operation composed by ::exios::when_all or
+ * ::exios::when_any. It's the only allocation the composition makes; Once
+ * every operation has finished, it's posted to the originating context as
+ * the operation that delivers the completion...
+ */
+template <typename Derived, typename F, typename Alloc, typename... Ops>
+struct ComposedState : AnyAsyncOperation
+{
+    static constexpr std::size_t kCount = sizeof...(Ops);
+
+    ComposedState(Context const& ctx, F&& f, Alloc const& alloc)
+        : AnyAsyncOperation { &ComposedState::thunk }
+        , ctx_ { ctx }
+        , work_ { ctx }
+        , f_ { std::move(f) }
+        , alloc_ { alloc }
+    {
+    }
+
+    /* Starts every operation. The state holds one extra count until
+     * they've all been started, so it can't be delivered (and freed) while
+     * this is still using it...
+     */
+    template <typename... Args>
+    auto start(Args&&... ops) noexcept -> void
+    {
+        start_each(std::index_sequence_for<Args...> {},
+                   std::forward<Args>(ops)...);
+        release();
+    }
+
+protected:
+    auto release() noexcept -> void
+    {
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            ctx_.post(this);
+    }
+
+    template <typename Result>
+    auto deliver(Result&& result) -> void
+    {
+        auto f = std::move(f_);
+        auto work = std::move(work_);
+        destroy();
+        f(std::forward<Result>(result));
+    }
+
+private:
+    template <std::size_t... Is, typename... Args>
+    auto start_each(std::index_sequence<Is...>, Args&&... ops) noexcept
+        -> void
+    {
+        (start_one<Is>(std::forward<Args>(ops)), ...);
+    }
+
+    template <std::size_t I, typename Op>
+    auto start_one(Op&& op) noexcept -> void
+    {
+        auto& self = static_cast<Derived&>(*this);
+        std::move(op.initiate)(
+            ComposedCompletion<Derived, I> { std::addressof(self) });
+        self.template started<I>(*op.object);
+    }
+
+    static auto thunk(AnyAsyncOperation& op, OperationAction action, void*)
+        -> bool
+    {
+        auto& self = static_cast<Derived&>(op);
+        if (action == OperationAction::dispatch)
+            self.invoke();
+        else
+            static_cast<ComposedState&>(self).destroy();
+
+        return true;
+    }
+
+    auto destroy() noexcept -> void
+    {
+        using SelfAlloc =
+            std::allocator_traits<Alloc>::template rebind_alloc<Derived>;
+        SelfAlloc alloc_tmp { alloc_ };
+        auto* self = static_cast<Derived*>(this);
+        self->~Derived();
+        alloc_tmp.deallocate(self, 1);
+    }
+
+    Context ctx_;
+    Work<Context> work_;
+    F f_;
+    Alloc alloc_;
+    std::atomic_size_t remaining_ { kCount + 1 };
+};
+
+template <typename F, typename Alloc, typename... Ops>
+struct WhenAllState final
+    : ComposedState<WhenAllState<F, Alloc, Ops...>, F, Alloc, Ops...>
+{
+    using Base = ComposedState<WhenAllState, F, Alloc, Ops...>;
+    using Base::Base;
+
+    template <std::size_t I, typename R>
+    auto complete(R&& result) -> void
+    {
+        std::get<I>(results_).emplace(std::forward<R>(result));
+        this->release();
+    }
+
+    template <std::size_t I>
+    auto started(IoObject&) noexcept -> void
+    {
+    }
+
+    auto invoke() -> void
+    {
+        auto results = std::apply(
+            [](auto&... r) {
+                return std::tuple<typename Ops::ResultType...> { std::move(
+                    *r)... };
+            },
+            results_);
+
+        this->deliver(std::move(results));
+    }
+
+private:
+    std::tuple<std::optional<typename Ops::ResultType>...> results_ {};
+};
+
+template <typename F, typename Alloc, typename... Ops>
+struct WhenAnyState final
+    : ComposedState<WhenAnyState<F, Alloc, Ops...>, F, Alloc, Ops...>
+{
+    using Base = ComposedState<WhenAnyState, F, Alloc, Ops...>;
+
+    WhenAnyState(Context const& ctx,
+                 F&& f,
+                 std::array<IoObject*, sizeof...(Ops)> objects,
+                 Alloc const& alloc)
+        : Base { ctx, std::move(f), alloc }
+        , objects_ { objects }
+    {
+    }
+
+    template <std::size_t I, typename R>
+    auto complete(R&& result) -> void
+    {
+        auto expected = kNoWinner;
+        if (winner_.compare_exchange_strong(expected, I)) {
+            result_.emplace(std::in_place_index<I>, std::forward<R>(result));
+            cancel_losers(I);
+        }
+
+        this->release();
+    }
+
+    /* An operation that's started after the winner was decided would
+     * otherwise miss its cancellation...
+     */
+    template <std::size_t I>
+    auto started(IoObject& object) noexcept -> void
+    {
+        if (auto const winner = winner_.load(); winner != kNoWinner &&
+                                                winner != I)
+            object.cancel();
+    }
+
+    /* The result is moved out first; `deliver()` frees the state before
+     * calling the completion...
+     */
+    auto invoke() -> void
+    {
+        auto result = std::move(*result_);
+        this->deliver(std::move(result));
+    }
+
+private:
+    static constexpr std::size_t kNoWinner =
+        std::numeric_limits<std::size_t>::max();
+
+    auto cancel_losers(std::size_t winner) noexcept -> void
+    {
+        for (std::size_t i = 0; i < objects_.size(); ++i) {
+            if (i != winner)
+                objects_[i]->cancel();
+        }
+    }
+
+    std::array<IoObject*, sizeof...(Ops)> objects_;
+    std::atomic_size_t winner_ { kNoWinner };
+    std::optional<std::variant<typename Ops::ResultType...>> result_ {};
+};
+
+template <typename State, typename Alloc, typename... Args>
+[[nodiscard]] auto allocate_composed_state(Alloc const& alloc, Args&&... args)
+    -> State*
+{
+    using StateAlloc =
+        std::allocator_traits<Alloc>::template rebind_alloc<State>;
+    StateAlloc alloc_tmp { alloc };
+
+    auto* ptr = alloc_tmp.allocate(1);
+
+    try {
+        return ::new (static_cast<void*>(ptr))
+            State { std::forward<Args>(args)..., alloc };
+    }
+    catch (...) {
+        alloc_tmp.deallocate(ptr, 1);
+        throw;
+    }
+}
+
+} // namespace detail
+
+/*!
+ * Starts every operation in `ops`, and calls `completion` once they've all
+ * finished, with a `std::tuple` of their results in the same order.
+ *
+ * The completion is posted to `ctx`, which has outstanding work until
+ * then. The state shared by the operations is the composition's only
+ * allocation, and is made with the completion's allocator if it has one,
+ * otherwise with the context's default.
+ *
+ * *NOTE*: An operation's `initiate` must not throw.
+ *
+ * ```
+ * exios::when_all(ctx, [](auto results) { ... },
+ *                 exios::defer<exios::IoResult>(a, ...),
+ *                 exios::defer<exios::IoResult>(b, ...));
+ * ```
+ */
+template <typename F, IsDeferredOperation... Ops>
+auto when_all(Context ctx, F&& completion, Ops... ops) -> void
+requires(sizeof...(Ops) > 0)
+{
+    auto const alloc = select_allocator(completion, ctx.get_allocator());
+    using State = detail::
+        WhenAllState<std::decay_t<F>, std::decay_t<decltype(alloc)>, Ops...>;
+
+    auto* state = detail::allocate_composed_state<State>(
+        alloc, ctx, std::move(completion));
+    state->start(std::move(ops)...);
+}
+
+/*!
+ * Starts every operation in `ops`, and calls `completion` with a
+ * `std::variant` holding the result of whichever finishes first; Its
+ * `index()` identifies the operation.
+ *
+ * The others are cancelled through ::exios::IoObject::cancel, which
+ * cancels every pending operation on their I/O objects, and their results
+ * are discarded. The completion is posted to `ctx` once every operation
+ * has finished, so nothing they refer to is still in use by then. As with
+ * ::exios::when_all, the shared state is the only allocation made.
+ *
+ * ```
+ * exios::when_any(ctx, [](auto result) {
+ *                     if (result.index() == 1) { ... timed out ... }
+ *                 },
+ *                 exios::defer<exios::IoResult>(socket, ...),
+ *                 exios::defer<exios::TimerOrEventIoResult>(timer, ...));
+ * ```
+ */
+template <typename F, IsDeferredOperation... Ops>
+auto when_any(Context ctx, F&& completion, Ops... ops) -> void
+requires(sizeof...(Ops) > 0)
+{
+    auto const alloc = select_allocator(completion, ctx.get_allocator());
+    using State = detail::
+        WhenAnyState<std::decay_t<F>, std::decay_t<decltype(alloc)>, Ops...>;
+
+    auto* state = detail::allocate_composed_state<State>(
+        alloc,
+        ctx,
+        std::move(completion),
+        std::array<IoObject*, sizeof...(Ops)> { ops.object... });
+    state->start(std::move(ops)...);
+}
+
+} // namespace exios
+
+#endif // EXIOS_COMBINATORS_HPP_INCLUDED
@@ -3,12 +3,16 @@
 
 #include "exios/async_operation.hpp"
 #include "exios/work.hpp"
+#include <cstddef>
+#include <memory_resource>
 
 namespace exios
 {
 
 struct ContextThread;
 struct IoScheduler;
+struct RecyclingPool;
+struct Scheduler;
 
 struct Context
 {
@@ -17,6 +21,14 @@ struct Context
     auto latch_work() noexcept -> void;
     auto release_work() noexcept -> void;
     auto io_scheduler() noexcept -> IoScheduler&;
+    [[nodiscard]] auto get_allocator() const noexcept
+        -> std::pmr::polymorphic_allocator<std::byte>;
+    [[nodiscard]] auto recycling_pool() const noexcept -> RecyclingPool&;
+
+    /*!
+     * Returns a scheduler for the context; See "exios/execution.hpp".
+     */
+    [[nodiscard]] auto get_scheduler() const noexcept -> Scheduler;
 
     template <typename F, typename Alloc>
     auto post(F&& f, Alloc const& alloc) -> void
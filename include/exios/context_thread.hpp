@@ -3,12 +3,16 @@
 
 #include "exios/alloc_utils.hpp"
 #include "exios/async_operation.hpp"
+#include "exios/atomic_intrusive_list.hpp"
 #include "exios/intrusive_list.hpp"
 #include "exios/io_scheduler.hpp"
+#include "exios/recycling_allocator.hpp"
 #include <atomic>
-#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <mutex>
+#include <vector>
 
 namespace exios
 {
@@ -18,6 +22,14 @@ struct ContextThread
     friend struct IoScheduler;
 
     ContextThread() noexcept;
+    /*!
+     * Uses `backend` for I/O, and allocates the I/O scheduler's per-FD
+     * table from `fd_table_resource`, which must outlive the context. See
+     * ::exios::IoScheduler.
+     */
+    explicit ContextThread(IoBackend backend,
+                           std::pmr::memory_resource* fd_table_resource =
+                               std::pmr::get_default_resource());
     ~ContextThread();
     ContextThread(ContextThread const&) = delete;
     auto operator=(ContextThread const&) -> ContextThread& = delete;
@@ -39,22 +51,93 @@ struct ContextThread
     auto post(F&& f) -> void
     requires(!std::is_convertible_v<F, AnyAsyncOperation*>)
     {
-        auto const alloc = select_allocator(f);
+        auto const alloc = select_allocator(f, get_allocator());
         post(std::forward<F>(f), alloc);
     }
 
     auto io_scheduler() noexcept -> IoScheduler&;
 
+    /*!
+     * Returns the allocator used for operations whose handlers don't
+     * provide one of their own. It allocates from `default_resource()`.
+     */
+    [[nodiscard]] auto get_allocator() const noexcept
+        -> std::pmr::polymorphic_allocator<std::byte>;
+
+    /*!
+     * Returns the resource that operations allocate from by default. This
+     * is the context's own ::exios::RecyclingPool unless it's been replaced
+     * with `set_default_resource()`.
+     */
+    [[nodiscard]] auto default_resource() const noexcept
+        -> std::pmr::memory_resource*;
+
+    /*!
+     * Replaces the default resource for operations created from now on.
+     * Operations that already exist still return their memory to the
+     * resource they came from, so `resource` must outlive any operations
+     * allocated from it. It must be safe to use from every thread that
+     * runs, or schedules work on, this context. Passing `nullptr` restores
+     * the context's own pool.
+     */
+    auto set_default_resource(std::pmr::memory_resource* resource) noexcept
+        -> void;
+
+    /*!
+     * Returns the context's own ::exios::RecyclingPool. Coroutine frames
+     * for tasks associated with the context are allocated from it.
+     */
+    [[nodiscard]] auto recycling_pool() noexcept -> RecyclingPool&;
+
+    /*!
+     * Returns the counters of the context's own ::exios::RecyclingPool.
+     */
+    [[nodiscard]] auto allocation_stats() const noexcept
+        -> RecyclingPoolStats;
+
+    /*!
+     * Returns the context whose `run()` the calling thread is inside, or
+     * `nullptr` if there isn't one.
+     */
+    [[nodiscard]] static auto current() noexcept -> ContextThread*;
+
     auto get_context() const noexcept -> Context;
 
 private:
-    auto notify() noexcept -> void;
+    /* A thread inside `run()`. Completions posted from that thread are
+     * queued locally, so chains of handlers stay on the same thread.
+     * Runners that have nothing to do steal from the others...
+     */
+    struct Runner;
+
+    static auto active_runner() noexcept -> Runner*&;
+    [[nodiscard]] auto current_runner() const noexcept -> Runner*;
+    auto retire_runner(Runner& runner) noexcept -> void;
+    auto push_local(Runner& runner, AnyAsyncOperation* op) noexcept -> bool;
+    [[nodiscard]] auto pop_local(Runner& runner) noexcept
+        -> AnyAsyncOperation*;
+    [[nodiscard]] auto steal_into(Runner& runner) noexcept -> std::size_t;
+    [[nodiscard]] auto run_local(Runner& runner) -> std::size_t;
+    [[nodiscard]] auto run_shared() -> std::size_t;
+    [[nodiscard]] auto has_completions() const noexcept -> bool;
+
+    auto notify(bool all = false) noexcept -> bool;
+    [[nodiscard]] auto ready_to_run() const noexcept -> bool;
 
+    /* Declared first so it outlives any operations still owned by the
+     * I/O scheduler...
+     */
+    RecyclingPool pool_;
+    std::atomic<std::pmr::memory_resource*> default_resource_ { &pool_ };
     IoScheduler io_scheduler_;
-    IntrusiveList<AnyAsyncOperation> completion_queue_;
+    AtomicIntrusiveList<AnyAsyncOperation> completion_queue_;
     std::atomic_size_t remaining_count_ { 0 };
-    std::mutex data_mutex_;
-    std::condition_variable cvar_;
+    std::atomic_size_t sleepers_ { 0 };
+    std::atomic_uint32_t wake_sequence_ { 0 };
+    std::atomic_bool polling_ { false };
+    std::mutex runners_mutex_;
+    std::vector<Runner*> runners_;
+    std::atomic_size_t locally_queued_ { 0 };
 };
 
 } // namespace exios
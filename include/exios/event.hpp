@@ -4,6 +4,7 @@
 #include "exios/alloc_utils.hpp"
 #include "exios/context.hpp"
 #include "exios/io.hpp"
+#include "exios/io_awaitable.hpp"
 #include "exios/io_object.hpp"
 #include "exios/work.hpp"
 #include <cinttypes>
@@ -53,7 +54,7 @@ struct Event : IoObject
     template <typename F>
     auto trigger(F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op =
             make_async_io_operation(event_write_operation,
@@ -69,7 +70,7 @@ struct Event : IoObject
     template <typename F>
     auto trigger_with_value(std::uint64_t val, F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op =
             make_async_io_operation(event_write_operation,
@@ -85,7 +86,7 @@ struct Event : IoObject
     template <typename F>
     auto wait_for_event(F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op =
             make_async_io_operation(event_read_operation,
@@ -96,6 +97,53 @@ struct Event : IoObject
 
         schedule_io(op);
     }
+
+    /*!
+     * Awaitable form of `trigger()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_trigger()
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this](auto&& completion) {
+                trigger(std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `trigger_with_value()`; Resumes with a
+     * ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_trigger_with_value(std::uint64_t val)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, val](auto&& completion) {
+                trigger_with_value(val, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `wait_for_event()`; Resumes with a
+     * ::exios::TimerOrEventIoResult.
+     */
+    [[nodiscard]] auto async_wait_for_event()
+    {
+        return make_io_awaitable<TimerOrEventIoResult>(
+            get_allocator(),
+            [this](auto&& completion) {
+                wait_for_event(std::move(completion));
+            });
+    }
+
+    /*!
+     * Sender form of `wait_for_event()`; Completes with the event's value.
+     */
+    [[nodiscard]] auto wait_for_event_sender()
+    {
+        return make_io_sender<TimerOrEventIoResult>(
+            event_read_operation, ctx_, fd_.value(), false);
+    }
 };
 
 } // namespace exios
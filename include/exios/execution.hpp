@@ -0,0 +1,567 @@
+#ifndef EXIOS_EXECUTION_HPP_INCLUDED
+#define EXIOS_EXECUTION_HPP_INCLUDED
+
+#include "exios/async_io_operation.hpp"
+#include "exios/async_operation.hpp"
+#include "exios/context.hpp"
+#include "exios/io.hpp"
+#include "exios/io_scheduler.hpp"
+#include "exios/result.hpp"
+#include "exios/work.hpp"
+#include <concepts>
+#include <functional>
+#include <optional>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/* A minimal sender/receiver model, after P2300's `std::execution`, for
+ * composing operations without allocating.
+ *
+ * - A *sender* describes work that hasn't started. It has a `value_type`,
+ *   (`void` if it completes with no value) and is `connect()`ed to a
+ *   receiver to produce an *operation state*.
+ * - A *receiver* is completed with exactly one of `set_value(value)`,
+ *   `set_error(std::error_code)` or `set_stopped()`. An operation that's
+ *   cancelled completes with `set_stopped()`.
+ * - An operation state is immovable, and does nothing until `start()`ed.
+ *   It must live until its receiver has been completed.
+ *
+ * Operation states embed everything they need, including the
+ * ::exios::AsyncIoOperation for I/O, so nothing is allocated at `connect()`
+ * or `start()`, and adaptors like ::exios::then are fused into the
+ * operation state of the sender they adapt.
+ *
+ * Exceptions thrown by receivers propagate from the context's `run()`, as
+ * with any other completion handler...
+ */
+
+namespace exios
+{
+
+template <typename S>
+concept Sender = requires { typename std::remove_cvref_t<S>::value_type; };
+
+template <typename R>
+concept Receiver = std::move_constructible<std::remove_cvref_t<R>> &&
+                   requires(std::remove_cvref_t<R>& r) {
+                       r.set_error(std::error_code {});
+                       r.set_stopped();
+                   };
+
+/*!
+ * Connects `sender` to `receiver`, returning the (immovable) operation
+ * state.
+ */
+template <Sender S, Receiver R>
+[[nodiscard]] auto connect(S sender, R receiver)
+{
+    return std::move(sender).connect(std::move(receiver));
+}
+
+template <typename Op>
+auto start(Op& op) noexcept -> void
+{
+    op.start();
+}
+
+template <Sender S, typename R>
+using ConnectResultType =
+    decltype(connect(std::declval<S>(), std::declval<R>()));
+
+namespace detail
+{
+
+template <typename F, typename V>
+struct InvokeWithValue
+{
+    using type = std::invoke_result_t<F, V>;
+};
+
+template <typename F>
+struct InvokeWithValue<F, void>
+{
+    using type = std::invoke_result_t<F>;
+};
+
+template <typename F, typename V>
+using InvokeWithValueType = typename InvokeWithValue<F, V>::type;
+
+/* Constructs an immovable operation state in place, E.g. in a
+ * `std::optional`, from the result of `f`...
+ */
+template <typename F>
+struct EmplaceFrom
+{
+    operator std::invoke_result_t<F>() && { return std::move(f)(); }
+
+    F f;
+};
+
+template <typename R, typename Result>
+auto complete_with_result(R& receiver, Result&& result) -> void
+{
+    using Value = typename std::remove_cvref_t<Result>::ResultType;
+
+    if (result.is_error_value()) {
+        if (result.error() == std::errc::operation_canceled)
+            receiver.set_stopped();
+        else
+            receiver.set_error(std::move(result).error());
+    }
+    else if constexpr (std::is_same_v<Value, VoidResult>)
+        receiver.set_value();
+    else
+        receiver.set_value(std::move(result).value());
+}
+
+template <typename R>
+struct ValueTypeOf
+{
+    using type = R;
+};
+
+template <>
+struct ValueTypeOf<VoidResult>
+{
+    using type = void;
+};
+
+struct NoPrelude
+{
+    auto operator()(int) const noexcept -> std::error_code { return {}; }
+};
+
+} // namespace detail
+
+template <typename R>
+struct ScheduleOperation;
+
+/*!
+ * Completes, with no value, from within the context's `run()`.
+ */
+struct ScheduleSender
+{
+    using value_type = void;
+
+    template <Receiver R>
+    [[nodiscard]] auto connect(R receiver) && -> ScheduleOperation<R>
+    {
+        return ScheduleOperation<R> { ctx, std::move(receiver) };
+    }
+
+    Context ctx;
+};
+
+template <typename R>
+struct ScheduleOperation final : AnyAsyncOperation
+{
+    ScheduleOperation(Context ctx, R&& receiver) noexcept
+        : AnyAsyncOperation { &ScheduleOperation::thunk }
+        , ctx_ { ctx }
+        , receiver_ { std::move(receiver) }
+    {
+    }
+
+    ScheduleOperation(ScheduleOperation&&) = delete;
+
+    auto start() noexcept -> void
+    {
+        work_.emplace(ctx_);
+        ctx_.post(this);
+    }
+
+private:
+    static auto thunk(AnyAsyncOperation& op, OperationAction action, void*)
+        -> bool
+    {
+        auto& self = static_cast<ScheduleOperation&>(op);
+        auto work = std::move(*self.work_);
+
+        if (action == OperationAction::dispatch)
+            self.receiver_.set_value();
+        else
+            self.receiver_.set_stopped();
+
+        return true;
+    }
+
+    Context ctx_;
+    R receiver_;
+    std::optional<Work<Context>> work_ {};
+};
+
+/*!
+ * Schedules work on an ::exios::Context. See `Context::get_scheduler()`.
+ */
+struct Scheduler
+{
+    explicit Scheduler(Context const& ctx) noexcept
+        : ctx_ { ctx }
+    {
+    }
+
+    [[nodiscard]] auto schedule() const noexcept -> ScheduleSender
+    {
+        return ScheduleSender { ctx_ };
+    }
+
+private:
+    Context ctx_;
+};
+
+template <typename OperationTag, typename Result, typename Prelude, typename R>
+struct IoOperationState;
+
+/*!
+ * An I/O operation on an FD, as a sender. It's created by the I/O objects'
+ * `*_sender()` members, and completes with the value of the operation's
+ * `Result`.
+ *
+ * `prelude` is called with the FD when the operation is started, before
+ * it's scheduled; If it returns an error, the operation completes with
+ * that instead.
+ */
+template <typename OperationTag,
+          typename Result,
+          typename Prelude = detail::NoPrelude,
+          typename... Args>
+struct IoSender
+{
+    using value_type =
+        typename detail::ValueTypeOf<typename Result::ResultType>::type;
+
+    template <Receiver R>
+    [[nodiscard]] auto connect(R receiver) &&
+        -> IoOperationState<OperationTag, Result, Prelude, R>
+    {
+        return std::apply(
+            [&](auto&&... operation_args) {
+                return IoOperationState<OperationTag, Result, Prelude, R> {
+                    ctx,
+                    fd,
+                    speculative,
+                    std::move(prelude),
+                    std::move(receiver),
+                    std::move(operation_args)...
+                };
+            },
+            std::move(args));
+    }
+
+    Context ctx;
+    int fd;
+    bool speculative;
+    Prelude prelude;
+    std::tuple<Args...> args;
+};
+
+template <typename Result, typename OperationTag, typename... Args>
+[[nodiscard]] auto make_io_sender(OperationTag const&,
+                                  Context const& ctx,
+                                  int fd,
+                                  bool speculative,
+                                  Args... args)
+    -> IoSender<OperationTag, Result, detail::NoPrelude, Args...>
+{
+    return IoSender<OperationTag, Result, detail::NoPrelude, Args...> {
+        ctx, fd, speculative, {}, { std::move(args)... }
+    };
+}
+
+/* The operation state of an ::exios::IoSender is itself the I/O
+ * operation that's scheduled...
+ */
+template <typename OperationTag, typename Result, typename Prelude, typename R>
+struct IoOperationState final : AsyncIoOperation
+{
+    using Operation = IoOperationType<OperationTag>;
+
+    template <typename... Args>
+    IoOperationState(Context ctx,
+                     int fd,
+                     bool speculative,
+                     Prelude&& prelude,
+                     R&& receiver,
+                     Args&&... args) noexcept
+        : AsyncIoOperation { &IoOperationState::thunk,
+                             ctx,
+                             fd,
+                             Operation::is_readable,
+                             waits_for_error_queue<Operation> }
+        , receiver_ { std::move(receiver) }
+        , prelude_ { std::move(prelude) }
+        , operation_ { std::forward<Args>(args)... }
+        , speculative_ { speculative }
+    {
+    }
+
+    IoOperationState(IoOperationState&&) = delete;
+
+    auto start() noexcept -> void
+    {
+        if (auto const ec = prelude_(get_fd()); ec) {
+            receiver_.set_error(ec);
+            return;
+        }
+
+        work_.emplace(get_context());
+
+        if (speculative_)
+            get_context().io_scheduler().schedule_speculative(this);
+        else
+            get_context().io_scheduler().schedule(this);
+    }
+
+private:
+    static auto thunk(AnyAsyncOperation& op, OperationAction action, void* arg)
+        -> bool
+    {
+        auto& self = static_cast<IoOperationState&>(op);
+
+        switch (action) {
+        case OperationAction::dispatch:
+            self.invoke();
+            break;
+        case OperationAction::discard: {
+            auto work = std::move(*self.work_);
+            self.receiver_.set_stopped();
+            break;
+        }
+        case OperationAction::perform_io:
+            return self.operation_.io(self.get_fd());
+        case OperationAction::prepare_submission:
+            self.operation_.prepare(self.get_fd(),
+                                    *static_cast<io_uring_sqe*>(arg));
+            break;
+        case OperationAction::complete_submission:
+            return self.operation_.complete(*static_cast<int*>(arg));
+        case OperationAction::cancel:
+            self.operation_.cancel();
+            break;
+        }
+
+        return true;
+    }
+
+    /* Completing the receiver may destroy the operation state, so nothing
+     * is touched afterwards...
+     */
+    auto invoke() -> void
+    {
+        auto work = std::move(*work_);
+        operation_.dispatch([&receiver = receiver_](Result&& result) {
+            detail::complete_with_result(receiver, std::move(result));
+        });
+    }
+
+    R receiver_;
+    Prelude prelude_;
+    Operation operation_;
+    std::optional<Work<Context>> work_ {};
+    bool speculative_;
+};
+
+namespace detail
+{
+
+template <typename F, typename R>
+struct ThenReceiver
+{
+    template <typename... Args>
+    auto set_value(Args&&... args) -> void
+    {
+        using Value = std::invoke_result_t<F, Args...>;
+
+        if constexpr (std::is_void_v<Value>) {
+            std::invoke(std::move(f), std::forward<Args>(args)...);
+            receiver.set_value();
+        }
+        else
+            receiver.set_value(
+                std::invoke(std::move(f), std::forward<Args>(args)...));
+    }
+
+    auto set_error(std::error_code ec) -> void { receiver.set_error(ec); }
+    auto set_stopped() -> void { receiver.set_stopped(); }
+
+    F f;
+    R receiver;
+};
+
+template <typename S, typename F>
+struct ThenSender
+{
+    using value_type = InvokeWithValueType<F, typename S::value_type>;
+
+    template <Receiver R>
+    [[nodiscard]] auto connect(R receiver) &&
+    {
+        return exios::connect(
+            std::move(sender),
+            ThenReceiver<F, R> { std::move(f), std::move(receiver) });
+    }
+
+    S sender;
+    F f;
+};
+
+/* Lets the operation started by ::exios::let_value complete the receiver
+ * that's owned by the enclosing operation state...
+ */
+template <typename R>
+struct ReceiverRef
+{
+    template <typename... Args>
+    auto set_value(Args&&... args) -> void
+    {
+        receiver->set_value(std::forward<Args>(args)...);
+    }
+
+    auto set_error(std::error_code ec) -> void { receiver->set_error(ec); }
+    auto set_stopped() -> void { receiver->set_stopped(); }
+
+    R* receiver;
+};
+
+template <typename S, typename F, typename R>
+struct LetValueOperation
+{
+    using Value = typename S::value_type;
+    using StoredValue =
+        std::conditional_t<std::is_void_v<Value>, std::monostate, Value>;
+    using NextSender = InvokeWithValueType<F, std::add_lvalue_reference_t<
+                                                  Value>>;
+
+    struct FirstReceiver
+    {
+        template <typename... Args>
+        auto set_value(Args&&... args) -> void
+        {
+            self->start_next(std::forward<Args>(args)...);
+        }
+
+        auto set_error(std::error_code ec) -> void
+        {
+            self->receiver_.set_error(ec);
+        }
+
+        auto set_stopped() -> void { self->receiver_.set_stopped(); }
+
+        LetValueOperation* self;
+    };
+
+    using FirstOperation = ConnectResultType<S, FirstReceiver>;
+    using NextOperation = ConnectResultType<NextSender, ReceiverRef<R>>;
+
+    LetValueOperation(S&& sender, F&& f, R&& receiver)
+        : f_ { std::move(f) }
+        , receiver_ { std::move(receiver) }
+        , first_ { exios::connect(std::move(sender), FirstReceiver { this }) }
+    {
+    }
+
+    LetValueOperation(LetValueOperation&&) = delete;
+
+    auto start() noexcept -> void { exios::start(first_); }
+
+private:
+    /* The value is kept alive, in the operation state, until the whole
+     * operation completes, so the next sender may refer to it...
+     */
+    template <typename... Args>
+    auto start_next(Args&&... args) -> void
+    {
+        auto& value = value_.emplace(std::forward<Args>(args)...);
+        auto& next = next_.emplace(EmplaceFrom { [&] {
+            if constexpr (std::is_void_v<Value>)
+                return exios::connect(std::invoke(std::move(f_)),
+                                      ReceiverRef<R> { &receiver_ });
+            else
+                return exios::connect(std::invoke(std::move(f_), value),
+                                      ReceiverRef<R> { &receiver_ });
+        } });
+
+        exios::start(next);
+    }
+
+    F f_;
+    R receiver_;
+    std::optional<StoredValue> value_ {};
+    FirstOperation first_;
+    std::optional<NextOperation> next_ {};
+};
+
+template <typename S, typename F>
+struct LetValueSender
+{
+    using value_type = typename InvokeWithValueType<
+        F,
+        std::add_lvalue_reference_t<typename S::value_type>>::value_type;
+
+    template <Receiver R>
+    [[nodiscard]] auto connect(R receiver) && -> LetValueOperation<S, F, R>
+    {
+        return LetValueOperation<S, F, R> { std::move(sender),
+                                            std::move(f),
+                                            std::move(receiver) };
+    }
+
+    S sender;
+    F f;
+};
+
+template <template <typename, typename> typename Adaptor, typename F>
+struct AdaptorClosure
+{
+    template <Sender S>
+    friend auto operator|(S sender, AdaptorClosure closure)
+    {
+        return Adaptor<S, F> { std::move(sender), std::move(closure.f) };
+    }
+
+    F f;
+};
+
+} // namespace detail
+
+/*!
+ * Adapts `sender` so it completes with the result of calling `f` with its
+ * value. Errors and stops are passed through.
+ */
+template <Sender S, typename F>
+[[nodiscard]] auto then(S sender, F f) -> detail::ThenSender<S, F>
+{
+    return detail::ThenSender<S, F> { std::move(sender), std::move(f) };
+}
+
+template <typename F>
+[[nodiscard]] auto then(F f) -> detail::AdaptorClosure<detail::ThenSender, F>
+{
+    return detail::AdaptorClosure<detail::ThenSender, F> { std::move(f) };
+}
+
+/*!
+ * Adapts `sender` so that, once it completes with a value, `f` is called
+ * with (a reference to) that value and the sender it returns is started
+ * in turn. The value lives until that sender completes.
+ */
+template <Sender S, typename F>
+[[nodiscard]] auto let_value(S sender, F f) -> detail::LetValueSender<S, F>
+{
+    return detail::LetValueSender<S, F> { std::move(sender), std::move(f) };
+}
+
+template <typename F>
+[[nodiscard]] auto let_value(F f)
+    -> detail::AdaptorClosure<detail::LetValueSender, F>
+{
+    return detail::AdaptorClosure<detail::LetValueSender, F> { std::move(
+        f) };
+}
+
+} // namespace exios
+
+#endif // EXIOS_EXECUTION_HPP_INCLUDED
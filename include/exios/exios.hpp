@@ -6,14 +6,22 @@
 #include "./async_operation.hpp"
 #include "./buffer_view.hpp"
 #include "./context.hpp"
+#include "./combinators.hpp"
 #include "./context_thread.hpp"
 #include "./event.hpp"
+#include "./execution.hpp"
 #include "./file_descriptor.hpp"
 #include "./intrusive_list.hpp"
 #include "./io.hpp"
+#include "./io_arena.hpp"
+#include "./io_awaitable.hpp"
+#include "./recycling_allocator.hpp"
 #include "./result.hpp"
 #include "./scope_guard.hpp"
+#include "./sharded_runtime.hpp"
 #include "./signal.hpp"
+#include "./splice.hpp"
+#include "./task.hpp"
 #include "./tcp_socket.hpp"
 #include "./timer.hpp"
 #include "./udp_socket.hpp"
@@ -36,8 +36,10 @@ struct IntrusiveList
             sentinel_.next = sentinel_.prev = &sentinel_;
         }
         else {
-            other.sentinel_.next->prev = &sentinel_;
-            other.sentinel_.prev->next = &sentinel_;
+            sentinel_.next = other.sentinel_.next;
+            sentinel_.prev = other.sentinel_.prev;
+            sentinel_.next->prev = &sentinel_;
+            sentinel_.prev->next = &sentinel_;
 
             other.sentinel_.next = other.sentinel_.prev = &other.sentinel_;
         }
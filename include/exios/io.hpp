@@ -4,15 +4,23 @@
 #include "exios/buffer_view.hpp"
 #include "exios/contracts.hpp"
 #include "exios/result.hpp"
+#include <array>
+#include <atomic>
 #include <cinttypes>
+#include <cstddef>
 #include <netinet/in.h>
 #include <optional>
+#include <span>
 #include <sys/signalfd.h>
 #include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <system_error>
 #include <tuple>
 
+struct io_uring_sqe;
+
 namespace exios
 {
 struct WriteOperation
@@ -21,6 +29,27 @@ struct WriteOperation
 struct ReadOperation
 {
 };
+struct WriteSomeOperation
+{
+};
+struct ReadSomeOperation
+{
+};
+struct WriteAllOperation
+{
+};
+struct ReadExactlyOperation
+{
+};
+struct TransferFileOperation
+{
+};
+struct SpliceInOperation
+{
+};
+struct SpliceOutOperation
+{
+};
 
 struct TimerExpiryOrEventOperation
 {
@@ -61,8 +90,39 @@ struct NetReceiveFromOperation
 {
 };
 
+struct NetSendBatchOperation
+{
+};
+
+struct NetReceiveBatchOperation
+{
+};
+
+struct NetSendSegmentedOperation
+{
+};
+
+struct NetReceiveCoalescedOperation
+{
+};
+
+struct ZerocopySendOperation
+{
+};
+
+struct ZerocopyReleaseOperation
+{
+};
+
 constexpr WriteOperation write_operation {};
 constexpr ReadOperation read_operation {};
+constexpr WriteSomeOperation write_some_operation {};
+constexpr ReadSomeOperation read_some_operation {};
+constexpr WriteAllOperation write_all_operation {};
+constexpr ReadExactlyOperation read_exactly_operation {};
+constexpr TransferFileOperation transfer_file_operation {};
+constexpr SpliceInOperation splice_in_operation {};
+constexpr SpliceOutOperation splice_out_operation {};
 constexpr TimerExpiryOrEventOperation timer_expiry_operation {};
 constexpr TimerExpiryOrEventOperation event_read_operation {};
 constexpr EventWriteOperation event_write_operation {};
@@ -74,6 +134,12 @@ constexpr ReceiveMessageOperation receive_message_operation {};
 constexpr NetConnectOperation net_connect_operation {};
 constexpr NetSendToOperation net_send_to_operation {};
 constexpr NetReceiveFromOperation net_receive_from_operation {};
+constexpr NetSendBatchOperation net_send_batch_operation {};
+constexpr NetReceiveBatchOperation net_receive_batch_operation {};
+constexpr NetSendSegmentedOperation net_send_segmented_operation {};
+constexpr NetReceiveCoalescedOperation net_receive_coalesced_operation {};
+constexpr ZerocopySendOperation zerocopy_send_operation {};
+constexpr ZerocopyReleaseOperation zerocopy_release_operation {};
 
 using IoResult = Result<std::size_t, std::error_code>;
 using ConnectResult = Result<std::error_code>;
@@ -84,11 +150,53 @@ using ReceiveMessageResult =
     Result<std::pair<std::size_t, msghdr>, std::error_code>;
 using ReceiveFromResult =
     Result<std::tuple<std::size_t, sockaddr_in>, std::error_code>;
+/*!
+ * A datagram received by ::exios::UdpSocket::receive_coalesced. If
+ * `segment_size` isn't `0` then the kernel coalesced several datagrams
+ * from the same source (GRO); The payload is then split into segments of
+ * `segment_size` bytes, the last of which may be shorter. `truncated` is
+ * set if the payload didn't fit in the buffer, or if the control message
+ * carrying `segment_size` was cut short.
+ */
+struct CoalescedDatagram
+{
+    std::size_t size;
+    sockaddr_in address;
+    std::uint16_t segment_size;
+    bool truncated;
+};
+
+using ReceiveCoalescedResult = Result<CoalescedDatagram, std::error_code>;
+using ZerocopySendResult =
+    Result<std::pair<std::size_t, std::uint32_t>, std::error_code>;
+using ZerocopyReleaseResult = Result<std::error_code>;
+
+/* True for operations that wait on their FD's error queue rather than for
+ * it to become readable or writable...
+ */
+template <typename Operation>
+inline constexpr bool waits_for_error_queue =
+    requires { requires Operation::waits_for_error_queue; };
 
 auto perform_read(int fd, BufferView buffer) noexcept -> IoResult;
 auto perform_write(int fd, ConstBufferView buffer) noexcept -> IoResult;
+auto perform_read_some(int fd, std::span<BufferView const> buffers) noexcept
+    -> IoResult;
+auto perform_write_some(int fd,
+                        std::span<ConstBufferView const> buffers) noexcept
+    -> IoResult;
 auto perform_timer_or_event_read(int fd) noexcept -> TimerOrEventIoResult;
 
+/* Each I/O operation can be performed in two ways;
+ *
+ * - `io(fd)` performs the I/O with a non-blocking syscall, for use once
+ *   the FD is known to be ready.
+ * - `prepare(fd, sqe)` describes the I/O as an io_uring submission, and
+ *   `complete(res)` consumes the result of that submission.
+ *
+ * Both `io()` and `complete()` return `false` if the I/O would block, in
+ * which case the operation is still pending and has no result...
+ */
 struct IoOpBase
 {
     template <typename F>
@@ -103,6 +211,17 @@ struct IoOpBase
 protected:
     auto set_result(IoResult&& r) noexcept -> void;
 
+    /* For operations that make progress in steps; Once any bytes have
+     * been transferred, an error or cancellation completes the operation
+     * short, with the bytes transferred so far. The error itself is
+     * dropped; One the failing call consumed, such as a pending
+     * `ECONNRESET`, isn't reported again, and a cancellation looks the
+     * same as a short transfer at the end of the stream...
+     */
+    auto set_partial_result(std::size_t transferred, IoResult&& r) noexcept
+        -> void;
+    auto cancel(std::size_t transferred) noexcept -> void;
+
 private:
     std::optional<IoResult> result_;
 };
@@ -113,6 +232,8 @@ struct IoRead : IoOpBase
 
     static constexpr auto is_readable = std::true_type {};
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
 
 private:
     BufferView buffer_;
@@ -124,15 +245,156 @@ struct IoWrite : IoOpBase
 
     static constexpr auto is_readable = std::false_type {};
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+
+private:
+    ConstBufferView buffer_;
+};
+
+/* Scatter/gather forms of `IoRead` and `IoWrite`, using `readv()` and
+ * `writev()`. The buffers are passed to the kernel as they are, so the
+ * span must outlive the operation...
+ */
+struct IoReadSome : IoOpBase
+{
+    IoReadSome(std::span<BufferView const>) noexcept;
+
+    static constexpr auto is_readable = std::true_type {};
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+
+private:
+    std::span<BufferView const> buffers_;
+};
+
+struct IoWriteSome : IoOpBase
+{
+    IoWriteSome(std::span<ConstBufferView const>) noexcept;
+
+    static constexpr auto is_readable = std::false_type {};
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+
+private:
+    std::span<ConstBufferView const> buffers_;
+};
+
+/* Transfer the whole buffer before completing. A partial transfer leaves
+ * the operation queued in the scheduler, so it's continued, in place, when
+ * the FD is next ready. The result is the number of bytes transferred,
+ * which is short of the buffer's size if a read reaches the end of the
+ * stream, or if an error or cancellation comes after some of the buffer
+ * was transferred; See `IoOpBase::set_partial_result()`...
+ */
+struct IoReadExactly : IoOpBase
+{
+    IoReadExactly(BufferView) noexcept;
+
+    static constexpr auto is_readable = std::true_type {};
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+    auto cancel() noexcept -> void;
+
+private:
+    BufferView buffer_;
+    std::size_t transferred_ { 0 };
+};
+
+struct IoWriteAll : IoOpBase
+{
+    IoWriteAll(ConstBufferView) noexcept;
+
+    static constexpr auto is_readable = std::false_type {};
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+    auto cancel() noexcept -> void;
 
 private:
     ConstBufferView buffer_;
+    std::size_t transferred_ { 0 };
+};
+
+/* Sends `count` bytes of a file, starting at `offset`, with `sendfile()`,
+ * so the data never passes through userspace. As with `IoWriteAll`, the
+ * operation stays queued until the whole range has been sent. The result
+ * is short of `count` if the file ends first, or, as with `IoWriteAll`, if
+ * an error or cancellation follows a partial transfer, which is then
+ * dropped. The file's own offset isn't changed.
+ *
+ * The kernel reads the file during each `sendfile()` call, which, as with
+ * all I/O performed once an FD is ready, is made with the scheduler's lock
+ * held. Reading a file that isn't in the page cache stalls the scheduler
+ * for as long as the disk takes; Each call only moves as much as the
+ * socket's buffer has room for, which bounds the stall, but doesn't
+ * remove it...
+ */
+struct IoTransferFile : IoOpBase
+{
+    IoTransferFile(int file_fd, off_t offset, std::size_t count) noexcept;
+
+    static constexpr auto is_readable = std::false_type {};
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+    auto cancel() noexcept -> void;
+
+private:
+    int file_fd_;
+    off_t offset_;
+    std::size_t count_;
+    std::size_t transferred_ { 0 };
+    int socket_fd_ { -1 };
+};
+
+/* Move data between an FD and a pipe with `splice()`, for use by
+ * ::exios::splice_between. `IoSpliceIn` moves whatever is available on the
+ * FD, up to `max` bytes, into the pipe; The pipe must have room for it, so
+ * that the only reason to block is the FD. `IoSpliceOut` moves `count`
+ * bytes, already in the pipe, out to the FD, and stays queued until
+ * they've all gone...
+ */
+struct IoSpliceIn : IoOpBase
+{
+    IoSpliceIn(int pipe_fd, std::size_t max) noexcept;
+
+    static constexpr auto is_readable = std::true_type {};
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+
+private:
+    int pipe_fd_;
+    std::size_t max_;
+    int fd_ { -1 };
+};
+
+struct IoSpliceOut : IoOpBase
+{
+    IoSpliceOut(int pipe_fd, std::size_t count) noexcept;
+
+    static constexpr auto is_readable = std::false_type {};
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+
+private:
+    int pipe_fd_;
+    std::size_t count_;
+    std::size_t transferred_ { 0 };
+    int fd_ { -1 };
 };
 
 struct ReceiveMessage
 {
     explicit ReceiveMessage(msghdr msg) noexcept;
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::true_type {};
@@ -153,6 +415,8 @@ struct SendMessage
 {
     explicit SendMessage(msghdr msg) noexcept;
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::false_type {};
@@ -173,6 +437,8 @@ struct NetSendTo
 {
     explicit NetSendTo(ConstBufferView buffer, sockaddr_in addr) noexcept;
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::false_type {};
@@ -188,12 +454,16 @@ private:
     std::optional<IoResult> result_;
     ConstBufferView buffer_;
     sockaddr_in addr_;
+    iovec iov_ {};
+    msghdr msg_ {};
 };
 
 struct NetReceiveFrom
 {
     explicit NetReceiveFrom(BufferView buffer) noexcept;
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::true_type {};
@@ -208,6 +478,227 @@ struct NetReceiveFrom
 private:
     std::optional<ReceiveFromResult> result_;
     BufferView buffer_;
+    sockaddr_in source_addr_ {};
+    iovec iov_ {};
+    msghdr msg_ {};
+};
+
+/*!
+ * A slot for one datagram received by
+ * ::exios::UdpSocket::receive_batch. The datagram is written to `buffer`;
+ * `size` and `address` are filled with its length and source, and
+ * `truncated` is set if it didn't fit.
+ */
+struct DatagramSlot
+{
+    BufferView buffer;
+    std::size_t size { 0 };
+    sockaddr_in address {};
+    bool truncated { false };
+};
+
+/*!
+ * One datagram sent by ::exios::UdpSocket::send_batch. It's sent to
+ * `address`, or to the socket's peer if `address.sin_family` is
+ * `AF_UNSPEC` and the socket is connected.
+ */
+struct Datagram
+{
+    ConstBufferView buffer;
+    sockaddr_in address {};
+};
+
+/* Move a batch of datagrams with `recvmmsg()` and `sendmmsg()`. The message
+ * headers for up to `kBatchSize` datagrams are held in the operation; The
+ * slots' buffers and addresses are passed to the kernel in place, so they
+ * must outlive the operation...
+ *
+ * A receive takes whatever datagrams are queued, without blocking once it
+ * has at least one, and its result is the number of slots filled. A send
+ * stays queued until every datagram has been sent, and its result is the
+ * number sent; Short if an error or cancellation follows a partial send.
+ * In either direction, an error that comes once some datagrams have been
+ * moved is dropped, as with `IoOpBase::set_partial_result()`...
+ */
+struct NetReceiveBatch : IoOpBase
+{
+    static constexpr std::size_t kBatchSize = 32;
+
+    explicit NetReceiveBatch(std::span<DatagramSlot> slots) noexcept;
+
+    static constexpr auto is_readable = std::true_type {};
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+
+private:
+    std::span<DatagramSlot> slots_;
+    std::array<mmsghdr, kBatchSize> headers_ {};
+    int fd_ { -1 };
+};
+
+struct NetSendBatch : IoOpBase
+{
+    static constexpr std::size_t kBatchSize = 32;
+
+    explicit NetSendBatch(std::span<Datagram const> datagrams) noexcept;
+
+    static constexpr auto is_readable = std::false_type {};
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+    auto cancel() noexcept -> void;
+
+private:
+    std::span<Datagram const> datagrams_;
+    std::array<mmsghdr, kBatchSize> headers_ {};
+    std::size_t sent_ { 0 };
+    int fd_ { -1 };
+};
+
+/* Sends a buffer as a train of datagrams of `segment_size` bytes, which
+ * the kernel (or NIC) splits up with UDP GSO. The segment size is passed
+ * with the message as a `UDP_SEGMENT` control message...
+ */
+struct NetSendSegmented
+{
+    NetSendSegmented(ConstBufferView buffer,
+                     sockaddr_in addr,
+                     std::uint16_t segment_size) noexcept;
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+    auto cancel() noexcept -> void;
+
+    static constexpr auto is_readable = std::false_type {};
+
+    template <typename F>
+    auto dispatch(F&& f) -> void
+    {
+        EXIOS_EXPECT(result_);
+        std::forward<F>(f)(std::move(*result_));
+    }
+
+private:
+    auto reset_message() noexcept -> void;
+
+    std::optional<IoResult> result_;
+    ConstBufferView buffer_;
+    sockaddr_in addr_;
+    std::uint16_t segment_size_;
+    alignas(cmsghdr) std::byte control_[CMSG_SPACE(sizeof(std::uint16_t))] {};
+    iovec iov_ {};
+    msghdr msg_ {};
+};
+
+/* Receives a datagram that may have been coalesced with others by UDP
+ * GRO, reporting the segment size from the `UDP_GRO` control message...
+ */
+struct NetReceiveCoalesced
+{
+    explicit NetReceiveCoalesced(BufferView buffer) noexcept;
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+    auto cancel() noexcept -> void;
+
+    static constexpr auto is_readable = std::true_type {};
+
+    template <typename F>
+    auto dispatch(F&& f) -> void
+    {
+        EXIOS_EXPECT(result_);
+        std::forward<F>(f)(std::move(*result_));
+    }
+
+private:
+    auto reset_message() noexcept -> void;
+    auto set_received(std::size_t size) noexcept -> void;
+
+    std::optional<ReceiveCoalescedResult> result_;
+    BufferView buffer_;
+    sockaddr_in source_addr_ {};
+    alignas(cmsghdr) std::byte control_[CMSG_SPACE(sizeof(int))] {};
+    iovec iov_ {};
+    msghdr msg_ {};
+};
+
+/* The `MSG_ZEROCOPY` notifications seen on a socket. The kernel numbers
+ * each successful zerocopy send in turn, starting from `0`, and reports
+ * ranges of those numbers on the socket's error queue once it's done with
+ * their buffers. TCP reports them in order, so we only need to know how
+ * far they've got...
+ */
+struct ZerocopyState
+{
+    std::atomic_uint32_t next_id { 0 };
+    std::atomic_uint32_t released { 0 };
+};
+
+/* Sends a buffer with `MSG_ZEROCOPY`. The result holds the number of bytes
+ * queued and the notification ID assigned to the send; The buffer mustn't
+ * be modified until that ID has been released...
+ */
+struct ZerocopySend
+{
+    ZerocopySend(ConstBufferView buffer, ZerocopyState* state) noexcept;
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+    auto cancel() noexcept -> void;
+
+    static constexpr auto is_readable = std::false_type {};
+
+    template <typename F>
+    auto dispatch(F&& f) -> void
+    {
+        EXIOS_EXPECT(result_);
+        std::forward<F>(f)(std::move(*result_));
+    }
+
+private:
+    auto set_sent(std::size_t size) noexcept -> void;
+
+    std::optional<ZerocopySendResult> result_;
+    ConstBufferView buffer_;
+    ZerocopyState* state_;
+    iovec iov_ {};
+    msghdr msg_ {};
+};
+
+/* Waits, on the socket's error queue, for the notification releasing the
+ * buffer of the zerocopy send with the given ID. Every notification read
+ * is recorded in the shared state, so a notification covering several
+ * sends releases each of them...
+ */
+struct ZerocopyRelease
+{
+    ZerocopyRelease(ZerocopyState* state, std::uint32_t id) noexcept;
+    auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
+    auto cancel() noexcept -> void;
+
+    static constexpr auto is_readable = std::true_type {};
+    static constexpr bool waits_for_error_queue = true;
+
+    template <typename F>
+    auto dispatch(F&& f) -> void
+    {
+        EXIOS_EXPECT(result_);
+        std::forward<F>(f)(std::move(*result_));
+    }
+
+private:
+    [[nodiscard]] auto released() noexcept -> bool;
+    auto reset_message() noexcept -> void;
+    auto record_notification() noexcept -> void;
+
+    std::optional<ZerocopyReleaseResult> result_;
+    ZerocopyState* state_;
+    std::uint32_t id_;
+    alignas(cmsghdr) std::byte control_[64] {};
+    msghdr msg_ {};
 };
 
 struct UnixConnect
@@ -215,6 +706,8 @@ struct UnixConnect
     explicit UnixConnect(std::string_view name) noexcept;
 
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::false_type {};
@@ -236,6 +729,8 @@ struct NetConnect
     explicit NetConnect(sockaddr_in addr) noexcept;
 
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::false_type {};
@@ -255,6 +750,8 @@ private:
 struct UnixAccept
 {
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::true_type {};
@@ -273,6 +770,8 @@ private:
 struct TimerExpiryOrEvent
 {
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::true_type {};
@@ -286,12 +785,15 @@ struct TimerExpiryOrEvent
 
 private:
     std::optional<TimerOrEventIoResult> result_;
+    std::uint64_t value_ { 0 };
 };
 
 struct EventWrite
 {
     explicit EventWrite(std::optional<std::uint64_t> value_to_write) noexcept;
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::false_type {};
@@ -306,11 +808,14 @@ struct EventWrite
 private:
     std::optional<std::uint64_t> value_to_write_;
     std::optional<IoResult> result_;
+    std::uint64_t value_ { 0 };
 };
 
 struct SignalRead
 {
     auto io(int fd) noexcept -> bool;
+    auto prepare(int fd, io_uring_sqe& sqe) noexcept -> void;
+    auto complete(int res) noexcept -> bool;
     auto cancel() noexcept -> void;
 
     static constexpr auto is_readable = std::true_type {};
@@ -324,6 +829,7 @@ struct SignalRead
 
 private:
     std::optional<SignalResult> result_;
+    signalfd_siginfo info_ {};
 };
 
 template <typename Tag>
@@ -341,6 +847,48 @@ struct IoOperation<WriteOperation>
     using type = IoWrite;
 };
 
+template <>
+struct IoOperation<ReadSomeOperation>
+{
+    using type = IoReadSome;
+};
+
+template <>
+struct IoOperation<WriteSomeOperation>
+{
+    using type = IoWriteSome;
+};
+
+template <>
+struct IoOperation<ReadExactlyOperation>
+{
+    using type = IoReadExactly;
+};
+
+template <>
+struct IoOperation<WriteAllOperation>
+{
+    using type = IoWriteAll;
+};
+
+template <>
+struct IoOperation<TransferFileOperation>
+{
+    using type = IoTransferFile;
+};
+
+template <>
+struct IoOperation<SpliceInOperation>
+{
+    using type = IoSpliceIn;
+};
+
+template <>
+struct IoOperation<SpliceOutOperation>
+{
+    using type = IoSpliceOut;
+};
+
 template <>
 struct IoOperation<TimerExpiryOrEventOperation>
 {
@@ -401,6 +949,42 @@ struct IoOperation<NetReceiveFromOperation>
     using type = NetReceiveFrom;
 };
 
+template <>
+struct IoOperation<NetSendBatchOperation>
+{
+    using type = NetSendBatch;
+};
+
+template <>
+struct IoOperation<NetReceiveBatchOperation>
+{
+    using type = NetReceiveBatch;
+};
+
+template <>
+struct IoOperation<NetSendSegmentedOperation>
+{
+    using type = NetSendSegmented;
+};
+
+template <>
+struct IoOperation<NetReceiveCoalescedOperation>
+{
+    using type = NetReceiveCoalesced;
+};
+
+template <>
+struct IoOperation<ZerocopySendOperation>
+{
+    using type = ZerocopySend;
+};
+
+template <>
+struct IoOperation<ZerocopyReleaseOperation>
+{
+    using type = ZerocopyRelease;
+};
+
 template <typename Tag>
 using IoOperationType = typename IoOperation<Tag>::type;
 
@@ -0,0 +1,99 @@
+#ifndef EXIOS_IO_ARENA_HPP_INCLUDED
+#define EXIOS_IO_ARENA_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace exios
+{
+
+/*!
+ * A bump allocator owned by a single ::exios::IoObject.
+ *
+ * Allocations are carved from a fixed block of memory and are never freed
+ * individually. The block is split into two halves, each of which resets
+ * to its start when the last allocation made from it is returned. A
+ * connection that alternates between scheduling and completing operations
+ * therefore reuses the same few bytes indefinitely.
+ *
+ * Allocation moves on to the other half once the current one is full. An
+ * operation that stays pending indefinitely, such as a read on a quiet
+ * full-duplex connection, keeps only its own half from resetting; The
+ * other goes on being reused by operations in the opposite direction.
+ * Requests that don't fit in what remains of either half go to the
+ * upstream resource.
+ *
+ * The arena is released by its owner with `release()`, and is destroyed
+ * once every allocation it has made has been returned.
+ */
+struct alignas(std::max_align_t) IoArena final : std::pmr::memory_resource
+{
+    static constexpr std::size_t kDefaultCapacity = 2048;
+
+    /*!
+     * Creates an arena with room for `capacity` bytes of operations.
+     * Requests that don't fit are passed to `upstream`, which must outlive
+     * the arena.
+     */
+    [[nodiscard]] static auto create(std::size_t capacity,
+                                     std::pmr::memory_resource* upstream)
+        -> IoArena*;
+
+    IoArena(IoArena const&) = delete;
+    auto operator=(IoArena const&) -> IoArena& = delete;
+
+    /*!
+     * Gives up the owner's reference to the arena. The arena is destroyed
+     * immediately if nothing allocated from it is still alive, otherwise
+     * when the last allocation is returned.
+     */
+    auto release() noexcept -> void;
+
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t;
+    [[nodiscard]] auto upstream() const noexcept -> std::pmr::memory_resource*;
+
+private:
+    IoArena(std::size_t capacity, std::pmr::memory_resource* upstream) noexcept;
+    ~IoArena() override = default;
+
+    auto do_allocate(std::size_t size, std::size_t alignment)
+        -> void* override;
+    auto do_deallocate(void* ptr,
+                       std::size_t size,
+                       std::size_t alignment) -> void override;
+    [[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other)
+        const noexcept -> bool override;
+
+    static constexpr std::size_t kHalves = 2;
+
+    [[nodiscard]] auto storage() noexcept -> std::byte*;
+    [[nodiscard]] auto owns(void const* ptr) noexcept -> bool;
+    [[nodiscard]] auto allocate_from(std::size_t half,
+                                     std::size_t size,
+                                     std::size_t alignment) noexcept
+        -> void*;
+    auto release_from(std::size_t half) noexcept -> void;
+    auto release_allocation() noexcept -> void;
+    auto destroy() noexcept -> void;
+
+    std::pmr::memory_resource* upstream_;
+    std::size_t capacity_;
+    std::size_t half_capacity_;
+
+    /* Each half's bump offset and number of live allocations, packed
+     * together so they're always updated as one...
+     */
+    std::atomic_uint64_t halves_[kHalves] {};
+    std::atomic_size_t current_ { 0 };
+
+    /* The number of live allocations, including those from upstream, and
+     * whether the owner has released the arena...
+     */
+    std::atomic_uint64_t state_ { 0 };
+};
+
+} // namespace exios
+
+#endif // EXIOS_IO_ARENA_HPP_INCLUDED
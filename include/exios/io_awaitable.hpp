@@ -0,0 +1,162 @@
+#ifndef EXIOS_IO_AWAITABLE_HPP_INCLUDED
+#define EXIOS_IO_AWAITABLE_HPP_INCLUDED
+
+#include <coroutine>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace exios
+{
+
+namespace detail
+{
+
+/* Space for one operation, embedded in an awaitable (and so in the
+ * awaiting coroutine's frame), and the resource to use when it won't
+ * do...
+ */
+struct InlineOperationStorage
+{
+    static constexpr std::size_t kSize = 256;
+
+    alignas(std::max_align_t) std::byte data[kSize];
+    bool in_use { false };
+    std::pmr::memory_resource* fallback;
+};
+
+/* Hands out the awaitable's storage for the operation. Anything that
+ * doesn't fit comes from the I/O object's allocator instead...
+ */
+template <typename T>
+struct InlineOperationAllocator
+{
+    using value_type = T;
+
+    explicit InlineOperationAllocator(InlineOperationStorage& storage) noexcept
+        : storage_ { &storage }
+    {
+    }
+
+    template <typename U>
+    InlineOperationAllocator(
+        InlineOperationAllocator<U> const& other) noexcept
+        : storage_ { other.storage_ }
+    {
+    }
+
+    [[nodiscard]] auto allocate(std::size_t n) -> T*
+    {
+        if (sizeof(T) * n <= InlineOperationStorage::kSize &&
+            alignof(T) <= alignof(std::max_align_t) && !storage_->in_use) {
+            storage_->in_use = true;
+            return reinterpret_cast<T*>(storage_->data);
+        }
+
+        return static_cast<T*>(
+            storage_->fallback->allocate(sizeof(T) * n, alignof(T)));
+    }
+
+    auto deallocate(T* ptr, std::size_t n) noexcept -> void
+    {
+        if (static_cast<void*>(ptr) == storage_->data) {
+            storage_->in_use = false;
+            return;
+        }
+
+        storage_->fallback->deallocate(ptr, sizeof(T) * n, alignof(T));
+    }
+
+    template <typename U>
+    auto operator==(InlineOperationAllocator<U> const& other) const noexcept
+        -> bool
+    {
+        return storage_ == other.storage_;
+    }
+
+private:
+    template <typename U>
+    friend struct InlineOperationAllocator;
+
+    InlineOperationStorage* storage_;
+};
+
+} // namespace detail
+
+/*!
+ * Adapts a callback-based operation so it can be `co_await`ed.
+ *
+ * `initiate` is called with a completion handler when the awaiting
+ * coroutine suspends; It should start the operation with that handler.
+ * The coroutine resumes with the operation's result, of type `T`, from
+ * the handler, which runs on the I/O object's context. The operation
+ * itself is allocated in the awaitable, so an await doesn't allocate;
+ * One too large for that comes from `alloc`, which should be the I/O
+ * object's `get_allocator()`.
+ */
+template <typename T, typename Initiate>
+struct IoAwaitable
+{
+    IoAwaitable(std::pmr::polymorphic_allocator<std::byte> const& alloc,
+                Initiate initiate) noexcept(
+        std::is_nothrow_move_constructible_v<Initiate>)
+        : initiate_ { std::move(initiate) }
+    {
+        storage_.fallback = alloc.resource();
+    }
+
+    IoAwaitable(IoAwaitable const&) = delete;
+    auto operator=(IoAwaitable const&) -> IoAwaitable& = delete;
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+    auto await_suspend(std::coroutine_handle<> continuation) -> void
+    {
+        continuation_ = continuation;
+        initiate_(Completion { this });
+    }
+
+    [[nodiscard]] auto await_resume() -> T { return std::move(*result_); }
+
+private:
+    struct Completion
+    {
+        template <typename R>
+        auto operator()(R&& result) -> void
+        {
+            self->result_.emplace(std::forward<R>(result));
+            self->continuation_.resume();
+        }
+
+        [[nodiscard]] auto get_allocator() const noexcept
+            -> detail::InlineOperationAllocator<std::byte>
+        {
+            return detail::InlineOperationAllocator<std::byte> {
+                self->storage_
+            };
+        }
+
+        IoAwaitable* self;
+    };
+
+    Initiate initiate_;
+    std::coroutine_handle<> continuation_ {};
+    std::optional<T> result_ {};
+    detail::InlineOperationStorage storage_ {};
+};
+
+template <typename T, typename Initiate>
+[[nodiscard]] auto make_io_awaitable(
+    std::pmr::polymorphic_allocator<std::byte> const& alloc,
+    Initiate&& initiate)
+{
+    return IoAwaitable<T, std::decay_t<Initiate>> {
+        alloc, std::forward<Initiate>(initiate)
+    };
+}
+
+} // namespace exios
+
+#endif // EXIOS_IO_AWAITABLE_HPP_INCLUDED
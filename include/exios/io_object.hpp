@@ -3,15 +3,67 @@
 
 #include "exios/async_io_operation.hpp"
 #include "exios/context.hpp"
+#include "exios/execution.hpp"
 #include "exios/file_descriptor.hpp"
+#include "exios/intrusive_list.hpp"
+#include "exios/io_arena.hpp"
+#include "exios/io_awaitable.hpp"
 #include "exios/work.hpp"
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
 
 namespace exios
 {
 
+namespace detail
+{
+
+/* Listed on both objects of a ::exios::splice_between while it runs, so
+ * that cancelling either of them cancels the splice as a whole...
+ */
+struct SpliceLink
+{
+    struct Hook : ListItemBase
+    {
+        SpliceLink* link { nullptr };
+    };
+
+    virtual auto cancel() noexcept -> void = 0;
+
+protected:
+    ~SpliceLink() = default;
+};
+
+/* The splices an object is part of. A splice is listed on both of its
+ * objects, which may belong to different contexts, so the list is
+ * guarded; A splice only goes away once it's been removed from both
+ * lists, so one that's listed can safely be cancelled...
+ */
+struct SpliceList
+{
+    auto add(SpliceLink::Hook* hook) noexcept -> void;
+    auto remove(SpliceLink::Hook* hook) noexcept -> void;
+    [[nodiscard]] auto empty() const noexcept -> bool;
+
+    /* Returns `false` if there was nothing to cancel...
+     */
+    auto cancel_all() noexcept -> bool;
+
+private:
+    mutable std::mutex mutex_;
+    IntrusiveList<SpliceLink::Hook> hooks_;
+};
+
+} // namespace detail
+
 struct IoObject
 {
     IoObject(Context const&, FileDescriptor&& fd) noexcept;
+    IoObject(IoObject&&) noexcept;
+    ~IoObject();
+
+    auto operator=(IoObject&&) noexcept -> IoObject&;
 
     auto get_context() const noexcept -> Context const&;
 
@@ -19,8 +71,47 @@ struct IoObject
 
     auto cancel() noexcept -> void;
 
+    /*!
+     * Registers the object's FD with the I/O scheduler for the lifetime of
+     * the object, rather than each time an operation is scheduled. See
+     * ::exios::IoScheduler::register_persistent.
+     *
+     * *NOTE*: Assigning to the object (E.g. when it's the target of an
+     * `accept()` operation) drops the registration, so this should be
+     * called once the object refers to the FD it will use.
+     */
+    auto enable_persistent_registration() -> void;
+
+    /*!
+     * Gives the object an ::exios::IoArena of `capacity` bytes, from which
+     * every operation scheduled on the object allocates unless its
+     * completion provides an allocator of its own. The arena allocates
+     * from each half of `capacity` in turn, so operations bigger than
+     * half of it, or that don't fit in what's left, fall back to the
+     * context's default resource. The arena is released when the object
+     * is closed or destroyed.
+     *
+     * *NOTE*: As with `enable_persistent_registration()`, assigning to the
+     * object drops the arena.
+     */
+    auto enable_arena(std::size_t capacity = IoArena::kDefaultCapacity)
+        -> void;
+
+    /*!
+     * Returns the allocator used for operations whose completions don't
+     * provide one of their own; The object's arena if it has one,
+     * otherwise the context's default.
+     */
+    [[nodiscard]] auto get_allocator() const noexcept
+        -> std::pmr::polymorphic_allocator<std::byte>;
+
 protected:
+    template <typename F>
+    friend auto splice_between(IoObject& from, IoObject& to, F&& completion)
+        -> void;
+
     auto schedule_io(AsyncIoOperation* op) noexcept -> void;
+    auto schedule_speculative_io(AsyncIoOperation* op) noexcept -> void;
 
     template <typename F, typename Alloc>
     auto post_completion(F&& f, Alloc const& alloc)
@@ -30,9 +121,18 @@ protected:
 
     Context ctx_;
     FileDescriptor fd_;
+
+private:
+    auto release_persistent_registration() noexcept -> void;
+    auto release_arena() noexcept -> void;
+
+    bool persistent_ { false };
+    IoArena* arena_ { nullptr };
+    detail::SpliceList splices_;
 };
 
 auto schedule_io(Context ctx, AsyncIoOperation* op) noexcept -> void;
+auto cancel_io(Context ctx, int fd) noexcept -> void;
 } // namespace exios
 
 #endif // EXIOS_EVENT_HPP_INCLUDED
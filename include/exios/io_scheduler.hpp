@@ -3,19 +3,45 @@
 
 #include "exios/async_io_operation.hpp"
 #include "exios/intrusive_list.hpp"
+#include "exios/io_uring.hpp"
 #include "exios/poll_wake_event.hpp"
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <vector>
 
 namespace exios
 {
 
 struct ContextThread;
 
+enum class IoBackend
+{
+    epoll,
+    io_uring,
+};
+
+/*!
+ * The backend used by contexts that don't ask for one explicitly. This is
+ * `IoBackend::epoll` unless the `EXIOS_IO_BACKEND` environment variable is
+ * set to `io_uring` and io_uring is supported by the kernel...
+ */
+[[nodiscard]] auto default_io_backend() noexcept -> IoBackend;
+
 struct IoScheduler
 {
-    IoScheduler(ContextThread&);
+    /*!
+     * The table of pending operations per FD, which grows to fit the
+     * highest FD scheduled, is allocated from `table_resource`. If it
+     * can't grow then the operation fails with `ENOMEM`.
+     */
+    IoScheduler(ContextThread&,
+                IoBackend backend = default_io_backend(),
+                std::pmr::memory_resource* table_resource =
+                    std::pmr::get_default_resource());
     ~IoScheduler();
 
     IoScheduler(IoScheduler const&) = delete;
@@ -24,17 +50,72 @@ struct IoScheduler
     auto wake() noexcept -> void;
     auto empty() const noexcept -> bool;
     auto schedule(AsyncIoOperation* op) noexcept -> void;
+
+    /*!
+     * As `schedule()`, but attempts the I/O before parking the operation.
+     * If the I/O doesn't block then the operation is posted straight to
+     * its context's completion queue without being registered with epoll.
+     * Operations already pending for the same FD and direction are never
+     * overtaken.
+     */
+    auto schedule_speculative(AsyncIoOperation* op) noexcept -> void;
     auto cancel(int fd) noexcept -> void;
+
+    /*!
+     * Registers `fd` with epoll once, for both reads and writes, in
+     * edge-triggered mode. The readiness of `fd` is then cached by the
+     * scheduler; Operations scheduled while `fd` is known to be ready are
+     * performed immediately, and are only parked when they would block.
+     *
+     * The registration remains until `release_persistent()` is called,
+     * which must happen before `fd` is closed.
+     *
+     * This is a no-op for the io_uring backend, which doesn't wait for
+     * readiness in the same way.
+     */
+    auto register_persistent(int fd) -> void;
+    auto release_persistent(int fd) noexcept -> void;
+
     [[nodiscard]] auto poll_once(bool block = true) -> std::size_t;
 
 private:
+    /* Pending operations for a single FD. Read, write and error queue
+     * operations are queued separately, in the order they were
+     * scheduled, and `interest` holds the events the FD is currently
+     * registered with epoll for (`0` if it isn't registered). For
+     * persistently registered FDs, `readiness` caches the events we know
+     * the FD is ready for...
+     */
+    struct FdSlot
+    {
+        IntrusiveList<AsyncIoOperation> reads;
+        IntrusiveList<AsyncIoOperation> writes;
+        IntrusiveList<AsyncIoOperation> errors;
+        std::uint32_t interest { 0 };
+        std::uint32_t readiness { 0 };
+        bool persistent { false };
+    };
+
+    auto schedule(AsyncIoOperation* op, bool speculative) noexcept -> void;
+    auto slot_for(int fd) -> FdSlot&;
+    static auto queue_for(FdSlot& slot, AsyncIoOperation& op) noexcept
+        -> IntrusiveList<AsyncIoOperation>&;
+    auto update_interest(int fd, FdSlot& slot) noexcept -> void;
+    [[nodiscard]] auto perform_ready_io(FdSlot& slot) noexcept -> std::size_t;
+    [[nodiscard]] auto process_notification(int fd,
+                                            std::uint32_t events) noexcept
+        -> std::size_t;
+
     ContextThread& ctx_;
     int epoll_fd_;
     PollWakeEvent wake_event_;
-    IntrusiveList<AsyncIoOperation> operations_;
-    IntrusiveList<AsyncIoOperation>::iterator begin_cancelled_;
+    std::pmr::vector<FdSlot> slots_;
+    IntrusiveList<AsyncIoOperation> cancelled_;
     mutable std::mutex data_mutex_;
     std::atomic_size_t poll_queue_length_ { 0 };
+    std::atomic_size_t waiters_ { 0 };
+    std::atomic_bool wake_pending_ { false };
+    std::unique_ptr<IoUring> uring_;
 };
 
 } // namespace exios
@@ -0,0 +1,119 @@
+#ifndef EXIOS_IO_URING_HPP_INCLUDED
+#define EXIOS_IO_URING_HPP_INCLUDED
+
+#include "exios/async_io_operation.hpp"
+#include "exios/intrusive_list.hpp"
+#include "exios/poll_wake_event.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace exios
+{
+
+/*!
+ * An io_uring implementation of the `IoScheduler` contract. Operations are
+ * described to the kernel as submissions rather than being performed once
+ * their FD is ready, and submissions are only passed to the kernel when a
+ * thread polls; Any number of operations scheduled between polls cost a
+ * single `io_uring_enter()` call.
+ *
+ * The kernel honours `O_NONBLOCK`, so a submission for an FD that isn't
+ * ready completes with `EAGAIN`. The operation then waits for the FD to
+ * become ready with a poll submission, and is resubmitted when it does.
+ */
+struct IoUring
+{
+    IoUring(PollWakeEvent& wake_event,
+            std::pmr::memory_resource* table_resource);
+    ~IoUring();
+
+    IoUring(IoUring const&) = delete;
+    auto operator=(IoUring const&) -> IoUring& = delete;
+
+    /*!
+     * Returns `true` if the kernel supports io_uring, and we're allowed to
+     * use it...
+     */
+    [[nodiscard]] static auto is_supported() noexcept -> bool;
+
+    auto empty() const noexcept -> bool;
+    auto schedule(AsyncIoOperation* op, bool speculative) noexcept -> void;
+    auto cancel(int fd) noexcept -> void;
+    [[nodiscard]] auto poll_once(bool block) -> std::size_t;
+
+private:
+    enum class Submission
+    {
+        none,
+        operation,
+        poll,
+    };
+
+    /* Pending operations for one direction of an FD, in the order they
+     * were scheduled. Only the operation at the front of `queue` is ever
+     * submitted, so operations can't overtake each other...
+     */
+    struct Direction
+    {
+        IntrusiveList<AsyncIoOperation> queue;
+        Submission submission { Submission::none };
+    };
+
+    struct FdSlot
+    {
+        Direction reads;
+        Direction writes;
+        Direction errors;
+    };
+
+    auto direction_for(AsyncIoOperation& op) -> Direction&;
+    [[nodiscard]] auto owned() const noexcept -> bool;
+    auto unmap() noexcept -> void;
+    auto push(io_uring_sqe const& sqe) noexcept -> void;
+    auto submit_front(Direction& direction) noexcept -> void;
+    auto submit_poll(Direction& direction) noexcept -> void;
+    auto submit_cancel(std::uint64_t user_data) noexcept -> void;
+    auto arm_wake() noexcept -> void;
+    auto flush() noexcept -> void;
+    [[nodiscard]] auto unsubmitted() const noexcept -> std::uint32_t;
+    [[nodiscard]] auto reap() noexcept -> std::size_t;
+    [[nodiscard]] auto process_completion(io_uring_cqe const& cqe) noexcept
+        -> std::size_t;
+
+    PollWakeEvent& wake_event_;
+    int ring_fd_;
+    std::uint64_t generation_ { 0 };
+    void* sq_ring_ { nullptr };
+    void* cq_ring_ { nullptr };
+    std::size_t sq_ring_size_ { 0 };
+    std::size_t cq_ring_size_ { 0 };
+    io_uring_sqe* sqes_ { nullptr };
+    std::size_t sqes_size_ { 0 };
+    std::uint32_t* sq_head_ { nullptr };
+    std::uint32_t* sq_tail_ { nullptr };
+    std::uint32_t* sq_array_ { nullptr };
+    std::uint32_t sq_mask_ { 0 };
+    std::uint32_t sq_entries_ { 0 };
+    std::uint32_t* cq_head_ { nullptr };
+    std::uint32_t* cq_tail_ { nullptr };
+    io_uring_cqe* cqes_ { nullptr };
+    std::uint32_t cq_mask_ { 0 };
+    std::pmr::vector<FdSlot> slots_;
+    IntrusiveList<AsyncIoOperation> cancelled_;
+    std::size_t in_flight_ { 0 };
+    bool stopping_ { false };
+    mutable std::mutex data_mutex_;
+    std::atomic_size_t poll_queue_length_ { 0 };
+    std::atomic_size_t waiters_ { 0 };
+};
+
+} // namespace exios
+
+#endif // EXIOS_IO_URING_HPP_INCLUDED
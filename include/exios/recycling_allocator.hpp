@@ -0,0 +1,147 @@
+#ifndef EXIOS_RECYCLING_ALLOCATOR_HPP_INCLUDED
+#define EXIOS_RECYCLING_ALLOCATOR_HPP_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <type_traits>
+
+namespace exios
+{
+
+/*!
+ * Hit/miss counters for a ::exios::RecyclingPool.
+ */
+struct RecyclingPoolStats
+{
+    /*! The total number of allocations made through the pool */
+    std::size_t allocations;
+    /*! Allocations satisfied by a previously freed block */
+    std::size_t recycled;
+    /*! Allocations that had to go to the global heap */
+    std::size_t heap_allocations;
+};
+
+/*!
+ * Recycles the memory of short-lived objects, such as async operations,
+ * rather than returning it to the heap.
+ *
+ * Blocks are grouped into power-of-two size classes, from
+ * `kMinBlockSize` to `kMaxBlockSize` bytes. Freed blocks go to a
+ * cache belonging to the calling thread, so the common case needs no
+ * synchronisation. When a thread's cache overflows, half of it is moved
+ * to a list shared by every thread using the pool, from which other
+ * threads refill their own caches. Allocations that are too large, or
+ * over-aligned, go straight to the heap.
+ *
+ * The pool is a `std::pmr::memory_resource`, so it can be used with
+ * `std::pmr::polymorphic_allocator` as well as ::exios::RecyclingAllocator.
+ */
+struct RecyclingPool : std::pmr::memory_resource
+{
+    static constexpr std::size_t kMinBlockSize = 32;
+    static constexpr std::size_t kMaxBlockSize = 4096;
+
+    RecyclingPool() noexcept = default;
+    ~RecyclingPool() override;
+
+    RecyclingPool(RecyclingPool const&) = delete;
+    auto operator=(RecyclingPool const&) -> RecyclingPool& = delete;
+
+    [[nodiscard]] auto stats() const noexcept -> RecyclingPoolStats;
+
+private:
+    static constexpr std::size_t kNumClasses = 8;
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct FreeList
+    {
+        FreeBlock* head { nullptr };
+        std::size_t size { 0 };
+    };
+
+    struct ThreadCache;
+
+    auto do_allocate(std::size_t size, std::size_t alignment)
+        -> void* override;
+    auto do_deallocate(void* ptr,
+                       std::size_t size,
+                       std::size_t alignment) -> void override;
+    [[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other)
+        const noexcept -> bool override;
+
+    [[nodiscard]] static auto thread_cache() noexcept -> ThreadCache*;
+    auto refill(std::size_t size_class,
+                FreeList& into,
+                std::size_t max) noexcept -> void;
+    auto spill(std::size_t size_class,
+               FreeList& from,
+               std::size_t count) noexcept -> void;
+
+    std::mutex mutex_;
+    std::array<FreeList, kNumClasses> shared_ {};
+    std::atomic_size_t allocations_ { 0 };
+    std::atomic_size_t recycled_ { 0 };
+    std::atomic_size_t heap_allocations_ { 0 };
+};
+
+/*!
+ * A standard allocator that draws from a particular
+ * ::exios::RecyclingPool. Operations don't need it by default; Those
+ * whose handlers don't provide an allocator use `Context::get_allocator()`,
+ * which already allocates from the context's pool unless its default
+ * resource has been replaced. A handler can return one from
+ * `get_allocator()` to keep its operations in a given pool regardless.
+ */
+template <typename T>
+struct RecyclingAllocator
+{
+    using value_type = T;
+
+    explicit RecyclingAllocator(RecyclingPool& pool) noexcept
+        : pool_ { &pool }
+    {
+    }
+
+    template <typename U>
+    RecyclingAllocator(RecyclingAllocator<U> const& other) noexcept
+        : pool_ { &other.pool() }
+    {
+    }
+
+    [[nodiscard]] auto allocate(std::size_t n) -> T*
+    requires(!std::is_void_v<T>)
+    {
+        return static_cast<T*>(pool_->allocate(sizeof(T) * n, alignof(T)));
+    }
+
+    auto deallocate(T* ptr, std::size_t n) noexcept -> void
+    requires(!std::is_void_v<T>)
+    {
+        pool_->deallocate(ptr, sizeof(T) * n, alignof(T));
+    }
+
+    [[nodiscard]] auto pool() const noexcept -> RecyclingPool&
+    {
+        return *pool_;
+    }
+
+    template <typename U>
+    auto operator==(RecyclingAllocator<U> const& other) const noexcept -> bool
+    {
+        return pool_ == &other.pool();
+    }
+
+private:
+    RecyclingPool* pool_;
+};
+
+} // namespace exios
+
+#endif // EXIOS_RECYCLING_ALLOCATOR_HPP_INCLUDED
@@ -0,0 +1,90 @@
+#ifndef EXIOS_SHARDED_RUNTIME_HPP_INCLUDED
+#define EXIOS_SHARDED_RUNTIME_HPP_INCLUDED
+
+#include "exios/alloc_utils.hpp"
+#include "exios/async_operation.hpp"
+#include "exios/context_thread.hpp"
+#include "exios/spsc_ring.hpp"
+#include "exios/work.hpp"
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace exios
+{
+
+/*!
+ * A shared-nothing runtime with one `ContextThread` per shard, each run
+ * by its own thread pinned to a CPU.
+ *
+ * Work posted from one shard to another travels through a ring dedicated
+ * to that pair of shards, rather than the target's shared completion
+ * queue. The target is only notified when the ring goes from idle to
+ * busy, so a burst of posts is delivered as a single batch.
+ */
+struct ShardedRuntime
+{
+    /*!
+     * \param num_shards The number of shards (and threads) to run.
+     * \param pin_threads If `true`, each shard's thread is pinned to one
+     * of the CPUs the process is allowed to run on.
+     * \param ring_capacity The capacity of each cross-shard ring. If a
+     * ring is full then work falls back to the target's completion
+     * queue.
+     */
+    explicit ShardedRuntime(std::size_t num_shards,
+                            bool pin_threads = true,
+                            std::size_t ring_capacity = 1024);
+    ~ShardedRuntime();
+
+    ShardedRuntime(ShardedRuntime const&) = delete;
+    auto operator=(ShardedRuntime const&) -> ShardedRuntime& = delete;
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+    [[nodiscard]] auto shard(std::size_t index) noexcept -> ContextThread&;
+
+    /*!
+     * Returns the index of the shard the calling thread runs, or
+     * `std::nullopt` if it isn't a shard thread.
+     */
+    [[nodiscard]] static auto current_shard() noexcept
+        -> std::optional<std::size_t>;
+
+    template <typename F, typename Alloc>
+    auto post_to(std::size_t index, F&& f, Alloc const& alloc) -> void
+    {
+        auto& target = shard(index);
+        deliver(index,
+                make_async_operation(wrap_work(std::forward<F>(f), target),
+                                     alloc));
+    }
+
+    template <typename F>
+    auto post_to(std::size_t index, F&& f) -> void
+    {
+        auto const alloc = select_allocator(f, shard(index).get_allocator());
+        post_to(index, std::forward<F>(f), alloc);
+    }
+
+    /*!
+     * Lets each shard's thread finish once it runs out of work. The
+     * destructor waits for them.
+     */
+    auto stop() noexcept -> void;
+
+private:
+    struct Shard;
+
+    auto deliver(std::size_t index, AnyAsyncOperation* op) noexcept -> void;
+    auto drain(std::size_t index) -> void;
+    auto ring(std::size_t from, std::size_t to) noexcept
+        -> SpscRing<AnyAsyncOperation>&;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<std::unique_ptr<SpscRing<AnyAsyncOperation>>> rings_;
+};
+
+} // namespace exios
+
+#endif // EXIOS_SHARDED_RUNTIME_HPP_INCLUDED
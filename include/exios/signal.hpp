@@ -4,6 +4,7 @@
 #include "exios/alloc_utils.hpp"
 #include "exios/async_io_operation.hpp"
 #include "exios/io.hpp"
+#include "exios/io_awaitable.hpp"
 #include "exios/io_object.hpp"
 
 namespace exios
@@ -16,7 +17,7 @@ struct Signal : IoObject
     template <typename F>
     auto wait(F&& f) -> void
     {
-        auto alloc = select_allocator(f);
+        auto alloc = select_allocator(f, get_allocator());
         auto* op = make_async_io_operation(signal_read_operation,
                                            wrap_work(std::forward<F>(f), ctx_),
                                            alloc,
@@ -25,6 +26,28 @@ struct Signal : IoObject
 
         schedule_io(op);
     }
+
+    /*!
+     * Awaitable form of `wait()`; Resumes with a ::exios::SignalResult.
+     */
+    [[nodiscard]] auto async_wait()
+    {
+        return make_io_awaitable<SignalResult>(
+            get_allocator(),
+            [this](auto&& completion) {
+                wait(std::move(completion));
+            });
+    }
+
+    /*!
+     * Sender form of `wait()`; Completes with the signal's
+     * `signalfd_siginfo`.
+     */
+    [[nodiscard]] auto wait_sender()
+    {
+        return make_io_sender<SignalResult>(
+            signal_read_operation, ctx_, fd_.value(), false);
+    }
 };
 
 } // namespace exios
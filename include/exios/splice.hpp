@@ -0,0 +1,255 @@
+#ifndef EXIOS_SPLICE_HPP_INCLUDED
+#define EXIOS_SPLICE_HPP_INCLUDED
+
+#include "exios/alloc_utils.hpp"
+#include "exios/async_io_operation.hpp"
+#include "exios/context.hpp"
+#include "exios/io.hpp"
+#include "exios/io_awaitable.hpp"
+#include "exios/io_object.hpp"
+#include "exios/work.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace exios
+{
+
+namespace detail
+{
+
+/* A pipe for ::exios::splice_between; Both ends are non-blocking...
+ */
+struct SplicePipe
+{
+    SplicePipe();
+    ~SplicePipe();
+
+    SplicePipe(SplicePipe const&) = delete;
+    auto operator=(SplicePipe const&) -> SplicePipe& = delete;
+
+    int read_fd;
+    int write_fd;
+    std::size_t capacity;
+};
+
+/* Drives a splice from one FD to another. The pipe is filled from `from`
+ * and then drained to `to`, in turn, so an operation only ever waits on
+ * its own FD. As only one is ever pending, and each is freed before its
+ * completion runs, they all share `op_storage_`. Cancelling either object
+ * cancels the operations of both, and stops the splice from scheduling
+ * any more...
+ */
+template <typename F, typename Alloc>
+struct SpliceState final : SpliceLink
+{
+    SpliceState(Context const& from_ctx,
+                int from_fd,
+                Context const& to_ctx,
+                int to_fd,
+                F&& f,
+                Alloc const& alloc,
+                std::pmr::memory_resource* fallback)
+        : from_ctx_ { from_ctx }
+        , to_ctx_ { to_ctx }
+        , from_work_ { from_ctx }
+        , to_work_ { to_ctx }
+        , from_fd_ { from_fd }
+        , to_fd_ { to_fd }
+        , f_ { std::move(f) }
+        , alloc_ { alloc }
+    {
+        from_hook_.link = this;
+        to_hook_.link = this;
+        op_storage_.fallback = fallback;
+    }
+
+    auto attach(SpliceList& from_splices, SpliceList& to_splices) noexcept
+        -> void
+    {
+        from_splices_ = &from_splices;
+        to_splices_ = &to_splices;
+        from_splices.add(&from_hook_);
+        to_splices.add(&to_hook_);
+    }
+
+    auto cancel() noexcept -> void override
+    {
+        cancelled_ = true;
+        cancel_io(from_ctx_, from_fd_);
+        cancel_io(to_ctx_, to_fd_);
+    }
+
+    auto fill() -> void
+    {
+        auto* op = make_async_io_operation(
+            splice_in_operation,
+            [this](IoResult result) { filled(std::move(result)); },
+            InlineOperationAllocator<std::byte> { op_storage_ },
+            from_ctx_,
+            from_fd_,
+            pipe_.write_fd,
+            pipe_.capacity);
+        static_assert(sizeof(std::remove_pointer_t<decltype(op)>) <=
+                      InlineOperationStorage::kSize);
+
+        exios::schedule_io(from_ctx_, op);
+    }
+
+private:
+    auto filled(IoResult result) -> void
+    {
+        if (!result || result.value() == 0) {
+            finish(std::move(result));
+            return;
+        }
+
+        if (cancelled_) {
+            finish(cancelled_result());
+            return;
+        }
+
+        auto* op = make_async_io_operation(
+            splice_out_operation,
+            [this](IoResult r) { drained(std::move(r)); },
+            InlineOperationAllocator<std::byte> { op_storage_ },
+            to_ctx_,
+            to_fd_,
+            pipe_.read_fd,
+            result.value());
+        static_assert(sizeof(std::remove_pointer_t<decltype(op)>) <=
+                      InlineOperationStorage::kSize);
+
+        exios::schedule_io(to_ctx_, op);
+    }
+
+    auto drained(IoResult result) -> void
+    {
+        if (!result) {
+            finish(std::move(result));
+            return;
+        }
+
+        total_ += result.value();
+        if (cancelled_)
+            finish(cancelled_result());
+        else
+            fill();
+    }
+
+    static auto cancelled_result() noexcept -> IoResult
+    {
+        return IoResult { result_error(
+            std::make_error_code(std::errc::operation_canceled)) };
+    }
+
+    /* A read of `0` bytes is the end of the stream, and the result is
+     * replaced by the total moved...
+     */
+    auto finish(IoResult result) -> void
+    {
+        auto f = std::move(f_);
+        auto from_work = std::move(from_work_);
+        auto to_work = std::move(to_work_);
+        auto const total = total_;
+        from_splices_->remove(&from_hook_);
+        to_splices_->remove(&to_hook_);
+        destroy();
+
+        if (result)
+            f(IoResult { result_ok(total) });
+        else
+            f(std::move(result));
+    }
+
+    auto destroy() noexcept -> void
+    {
+        using SelfAlloc =
+            std::allocator_traits<Alloc>::template rebind_alloc<SpliceState>;
+        SelfAlloc alloc_tmp { alloc_ };
+        this->~SpliceState();
+        alloc_tmp.deallocate(this, 1);
+    }
+
+    Context from_ctx_;
+    Context to_ctx_;
+    Work<Context> from_work_;
+    Work<Context> to_work_;
+    int from_fd_;
+    int to_fd_;
+    F f_;
+    Alloc alloc_;
+    SplicePipe pipe_ {};
+    InlineOperationStorage op_storage_ {};
+    std::size_t total_ { 0 };
+    std::atomic<bool> cancelled_ { false };
+    SpliceLink::Hook from_hook_ {};
+    SpliceLink::Hook to_hook_ {};
+    SpliceList* from_splices_ { nullptr };
+    SpliceList* to_splices_ { nullptr };
+};
+
+} // namespace detail
+
+/*!
+ * Moves everything read from `from` to `to`, until `from` reaches the end
+ * of its stream, with `splice()` through a pipe; The data never passes
+ * through userspace. Upon completion, `completion` is invoked with a
+ * ::exios::IoResult holding the total number of bytes moved, or the first
+ * error either side reports. Cancelling either object cancels the splice,
+ * along with any other operations pending on both objects; Data already
+ * taken from `from` but not yet written to `to` is dropped.
+ *
+ * The pipe and the splice's state are allocated up front, with
+ * `completion`'s allocator if it has one, otherwise `from`'s; A
+ * ::std::system_error is thrown if the pipe can't be created. The
+ * operations that move each chunk reuse space in that state, rather than
+ * allocating. Both objects must outlive the splice, and can't be moved
+ * while it runs. Neither should have other operations of the same
+ * direction (reads on `from`, writes on `to`) pending at the same time.
+ *
+ * ```
+ * exios::splice_between(client, upstream, [](exios::IoResult result) {
+ *     ...
+ * });
+ * ```
+ */
+template <typename F>
+auto splice_between(IoObject& from, IoObject& to, F&& completion) -> void
+{
+    auto const alloc = select_allocator(completion, from.get_allocator());
+    auto* const fallback = from.get_allocator().resource();
+    using State =
+        detail::SpliceState<std::decay_t<F>, std::decay_t<decltype(alloc)>>;
+    using StateAlloc = std::allocator_traits<
+        std::decay_t<decltype(alloc)>>::template rebind_alloc<State>;
+    StateAlloc alloc_tmp { alloc };
+
+    auto* ptr = alloc_tmp.allocate(1);
+    State* state;
+
+    try {
+        state = ::new (static_cast<void*>(ptr)) State { from.ctx_,
+                                                        from.fd_.value(),
+                                                        to.ctx_,
+                                                        to.fd_.value(),
+                                                        std::move(completion),
+                                                        alloc,
+                                                        fallback };
+    }
+    catch (...) {
+        alloc_tmp.deallocate(ptr, 1);
+        throw;
+    }
+
+    state->attach(from.splices_, to.splices_);
+    state->fill();
+}
+
+} // namespace exios
+
+#endif // EXIOS_SPLICE_HPP_INCLUDED
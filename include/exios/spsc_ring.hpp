@@ -0,0 +1,91 @@
+#ifndef EXIOS_SPSC_RING_HPP_INCLUDED
+#define EXIOS_SPSC_RING_HPP_INCLUDED
+
+#include "exios/contracts.hpp"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace exios
+{
+
+/*!
+ * A fixed capacity ring of pointers with a single producer thread and a
+ * single consumer thread. Neither side ever blocks; `try_push()` fails if
+ * the ring is full.
+ */
+template <typename T>
+struct SpscRing
+{
+    /*!
+     * \param capacity The maximum number of items in the ring. This is
+     * rounded up to a power of two.
+     */
+    explicit SpscRing(std::size_t capacity)
+        : slots_ { std::make_unique<T*[]>(std::bit_ceil(capacity)) }
+        , mask_ { std::bit_ceil(capacity) - 1 }
+    {
+        EXIOS_EXPECT(capacity > 0);
+    }
+
+    SpscRing(SpscRing const&) = delete;
+    auto operator=(SpscRing const&) -> SpscRing& = delete;
+
+    [[nodiscard]] auto try_push(T* item) noexcept -> bool
+    {
+        auto const tail = tail_.load(std::memory_order_relaxed);
+
+        /* We only look at the consumer's position when our cached copy
+         * says we're full...
+         */
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_)
+                return false;
+        }
+
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] auto try_pop() noexcept -> T*
+    {
+        auto const head = head_.load(std::memory_order_relaxed);
+
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_)
+                return nullptr;
+        }
+
+        auto* item = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return item;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    std::unique_ptr<T*[]> slots_;
+    std::size_t mask_;
+
+    /* The consumer's and producer's state live on separate cache lines
+     * so the two threads don't contend...
+     */
+    alignas(kCacheLineSize) std::atomic_size_t head_ { 0 };
+    std::size_t cached_tail_ { 0 };
+    alignas(kCacheLineSize) std::atomic_size_t tail_ { 0 };
+    std::size_t cached_head_ { 0 };
+};
+
+} // namespace exios
+
+#endif // EXIOS_SPSC_RING_HPP_INCLUDED
@@ -0,0 +1,389 @@
+#ifndef EXIOS_TASK_HPP_INCLUDED
+#define EXIOS_TASK_HPP_INCLUDED
+
+#include "exios/context.hpp"
+#include "exios/work.hpp"
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace exios
+{
+
+template <typename T = void>
+struct Task;
+
+namespace detail
+{
+
+template <typename T>
+concept HasRecyclingPool = requires(T& t) {
+    { t.recycling_pool() } -> std::same_as<RecyclingPool&>;
+};
+
+template <typename T>
+concept HasContextWithRecyclingPool = requires(T& t) {
+    { t.get_context() } -> HasRecyclingPool;
+};
+
+/* The pool of the context that's running on this thread, if any, or
+ * otherwise the default memory resource...
+ */
+[[nodiscard]] auto fallback_frame_resource() noexcept
+    -> std::pmr::memory_resource*;
+
+[[nodiscard]] auto as_frame_resource(RecyclingPool& pool) noexcept
+    -> std::pmr::memory_resource*;
+
+template <typename T>
+[[nodiscard]] auto frame_resource_of(T const& arg) noexcept
+    -> std::pmr::memory_resource*
+{
+    if constexpr (HasRecyclingPool<T>)
+        return as_frame_resource(const_cast<T&>(arg).recycling_pool());
+    else if constexpr (HasContextWithRecyclingPool<T>)
+        return as_frame_resource(
+            const_cast<T&>(arg).get_context().recycling_pool());
+    else
+        return nullptr;
+}
+
+/* Picks where a coroutine's frame is allocated from its arguments: The
+ * pool of the first context (or I/O object's context) it's passed...
+ */
+template <typename... Args>
+[[nodiscard]] auto select_frame_resource(Args const&... args) noexcept
+    -> std::pmr::memory_resource*
+{
+    std::pmr::memory_resource* resource = nullptr;
+    static_cast<void>(
+        ((resource = frame_resource_of(args), resource != nullptr) || ...));
+
+    return resource != nullptr ? resource : fallback_frame_resource();
+}
+
+/* The resource a frame came from is stored just in front of it, since
+ * the frame's arguments aren't available when it's freed...
+ */
+[[nodiscard]] auto allocate_frame(std::size_t size,
+                                  std::pmr::memory_resource* resource)
+    -> void*;
+
+auto deallocate_frame(void* frame, std::size_t size) noexcept -> void;
+
+/* Gives a coroutine's promise type pooled frame allocation...
+ */
+struct PooledFrame
+{
+    template <typename... Args>
+    [[nodiscard]] static auto operator new(std::size_t size,
+                                           Args const&... args) -> void*
+    {
+        return allocate_frame(size, select_frame_resource(args...));
+    }
+
+    static auto operator delete(void* frame, std::size_t size) noexcept
+        -> void
+    {
+        deallocate_frame(frame, size);
+    }
+};
+
+struct TaskPromiseBase : PooledFrame
+{
+    struct FinalAwaiter
+    {
+        [[nodiscard]] auto await_ready() const noexcept -> bool
+        {
+            return false;
+        }
+
+        template <typename Promise>
+        [[nodiscard]] auto
+        await_suspend(std::coroutine_handle<Promise> h) const noexcept
+            -> std::coroutine_handle<>
+        {
+            if (auto continuation = h.promise().continuation; continuation)
+                return continuation;
+
+            return std::noop_coroutine();
+        }
+
+        auto await_resume() const noexcept -> void {}
+    };
+
+    [[nodiscard]] auto initial_suspend() const noexcept -> std::suspend_always
+    {
+        return {};
+    }
+
+    [[nodiscard]] auto final_suspend() const noexcept -> FinalAwaiter
+    {
+        return {};
+    }
+
+    auto unhandled_exception() noexcept -> void
+    {
+        exception = std::current_exception();
+    }
+
+    auto rethrow_if_exception() -> void
+    {
+        if (exception)
+            std::rethrow_exception(std::exchange(exception, nullptr));
+    }
+
+    std::coroutine_handle<> continuation {};
+    std::exception_ptr exception {};
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase
+{
+    [[nodiscard]] auto get_return_object() noexcept -> Task<T>;
+
+    template <typename U>
+    auto return_value(U&& value) -> void
+    requires(std::is_convertible_v<U, T>)
+    {
+        result.emplace(std::forward<U>(value));
+    }
+
+    [[nodiscard]] auto take_result() -> T
+    {
+        rethrow_if_exception();
+        return std::move(*result);
+    }
+
+    std::optional<T> result {};
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase
+{
+    [[nodiscard]] auto get_return_object() noexcept -> Task<void>;
+
+    auto return_void() noexcept -> void {}
+
+    auto take_result() -> void { rethrow_if_exception(); }
+};
+
+} // namespace detail
+
+/*!
+ * A lazily started coroutine producing a `T`.
+ *
+ * A task doesn't run until it's `co_await`ed by another coroutine, or
+ * started on a context with ::exios::spawn. An awaiting coroutine is
+ * resumed, on the same thread, as soon as the task finishes; Exceptions
+ * thrown by the task are rethrown from the `co_await`.
+ *
+ * ```
+ * auto echo(exios::UnixSocket& socket) -> exios::Task<>
+ * {
+ *     std::array<char, 64> buffer;
+ *     for (;;) {
+ *         auto result = co_await socket.async_read(
+ *             exios::BufferView { buffer.data(), buffer.size() });
+ *         if (!result || result.value() == 0)
+ *             co_return;
+ *
+ *         co_await socket.async_write(
+ *             exios::ConstBufferView { buffer.data(), result.value() });
+ *     }
+ * }
+ *
+ * exios::spawn(thread, echo(socket));
+ * ```
+ *
+ * A task's coroutine frame is allocated from the ::exios::RecyclingPool of
+ * the first ::exios::Context, ::exios::ContextThread or I/O object passed
+ * to the coroutine; Failing that, from the pool of the context running on
+ * the calling thread, if any. Such a task mustn't outlive the context
+ * whose pool it was allocated from.
+ */
+template <typename T>
+struct [[nodiscard]] Task
+{
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task(Task&& other) noexcept
+        : handle_ { std::exchange(other.handle_, nullptr) }
+    {
+    }
+
+    auto operator=(Task&& other) noexcept -> Task&
+    {
+        if (this != &other) {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+
+        return *this;
+    }
+
+    ~Task()
+    {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            [[nodiscard]] auto await_ready() const noexcept -> bool
+            {
+                return false;
+            }
+
+            [[nodiscard]] auto
+            await_suspend(std::coroutine_handle<> continuation) noexcept
+                -> std::coroutine_handle<>
+            {
+                handle.promise().continuation = continuation;
+                return handle;
+            }
+
+            auto await_resume() -> T { return handle.promise().take_result(); }
+
+            Handle handle;
+        };
+
+        return Awaiter { handle_ };
+    }
+
+private:
+    friend promise_type;
+
+    explicit Task(Handle handle) noexcept
+        : handle_ { handle }
+    {
+    }
+
+    Handle handle_;
+};
+
+namespace detail
+{
+
+template <typename T>
+auto TaskPromise<T>::get_return_object() noexcept -> Task<T>
+{
+    return Task<T> { std::coroutine_handle<TaskPromise<T>>::from_promise(
+        *this) };
+}
+
+inline auto TaskPromise<void>::get_return_object() noexcept -> Task<void>
+{
+    return Task<void> { std::coroutine_handle<TaskPromise<void>>::from_promise(
+        *this) };
+}
+
+/* Owns a spawned task once it's been started. It destroys itself when the
+ * task finishes...
+ */
+struct DetachedTask
+{
+    struct promise_type : PooledFrame
+    {
+        [[nodiscard]] auto get_return_object() noexcept -> DetachedTask
+        {
+            return DetachedTask {
+                std::coroutine_handle<promise_type>::from_promise(*this)
+            };
+        }
+
+        [[nodiscard]] auto initial_suspend() const noexcept
+            -> std::suspend_always
+        {
+            return {};
+        }
+
+        [[nodiscard]] auto final_suspend() const noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        auto return_void() noexcept -> void {}
+        [[noreturn]] auto unhandled_exception() noexcept -> void
+        {
+            std::terminate();
+        }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+inline auto run_detached(Context ctx, Work<Context>, Task<void> task)
+    -> DetachedTask
+{
+    std::exception_ptr exception;
+
+    try {
+        co_await std::move(task);
+    }
+    catch (...) {
+        exception = std::current_exception();
+    }
+
+    /* Rethrown from the context's `run()`, as with any other handler that
+     * throws...
+     */
+    if (exception)
+        ctx.post([exception] { std::rethrow_exception(exception); },
+                 ctx.get_allocator());
+}
+
+/* Destroys a spawned task that never got to run; E.g. if the context is
+ * destroyed first...
+ */
+struct StartDetachedTask
+{
+    explicit StartDetachedTask(std::coroutine_handle<> h) noexcept
+        : handle { h }
+    {
+    }
+
+    StartDetachedTask(StartDetachedTask&& other) noexcept
+        : handle { std::exchange(other.handle, nullptr) }
+    {
+    }
+
+    ~StartDetachedTask()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    auto operator()() -> void { std::exchange(handle, nullptr).resume(); }
+
+    std::coroutine_handle<> handle;
+};
+
+} // namespace detail
+
+/*!
+ * Starts `task` on `ctx`. The task first runs from within the context's
+ * `run()`, and the context has outstanding work until it finishes. If the
+ * task throws, the exception is rethrown from `run()`.
+ */
+inline auto spawn(Context ctx, Task<void> task) -> void
+{
+    auto detached =
+        detail::run_detached(ctx, Work<Context> { ctx }, std::move(task));
+
+    ctx.post(detail::StartDetachedTask { detached.handle },
+             ctx.get_allocator());
+}
+
+} // namespace exios
+
+#endif // EXIOS_TASK_HPP_INCLUDED
@@ -6,8 +6,10 @@
 #include "exios/context.hpp"
 #include "exios/file_descriptor.hpp"
 #include "exios/io.hpp"
+#include "exios/io_awaitable.hpp"
 #include "exios/io_object.hpp"
 #include "exios/work.hpp"
+#include <algorithm>
 #include <bits/types/struct_itimerspec.h>
 #include <chrono>
 #include <cinttypes>
@@ -37,7 +39,8 @@ struct Timer : IoObject
     {
         cancel();
         if (duration == std::chrono::nanoseconds::zero()) {
-            auto const alloc = select_allocator(completion);
+            auto const alloc =
+                select_allocator(completion, get_allocator());
             auto f = [completion = std::move(completion)]() mutable {
                 std::move(completion)(TimerOrEventIoResult { result_ok(0ull) });
             };
@@ -54,7 +57,53 @@ struct Timer : IoObject
             throw std::system_error { errno, std::system_category() };
         }
 
-        queue_timer_operation(ctx_, fd_.value(), std::forward<F>(completion));
+        queue_timer_operation(
+            ctx_, fd_.value(), std::forward<F>(completion), get_allocator());
+    }
+
+    /*!
+     * Awaitable form of `wait_for_expiry_after()`; Resumes with a
+     * ::exios::TimerOrEventIoResult.
+     */
+    template <typename Rep, typename Period>
+    [[nodiscard]] auto
+    async_wait_for_expiry_after(std::chrono::duration<Rep, Period> duration)
+    {
+        return make_io_awaitable<TimerOrEventIoResult>(
+            get_allocator(),
+            [this, duration](auto&& completion) {
+                wait_for_expiry_after(duration, std::move(completion));
+            });
+    }
+
+    /*!
+     * Sender form of `wait_for_expiry_after()`; Completes with the number
+     * of expirations. The timer is armed when the operation is started.
+     */
+    template <typename Rep, typename Period>
+    [[nodiscard]] auto
+    wait_for_expiry_after_sender(std::chrono::duration<Rep, Period> duration)
+    {
+        /* A zero `itimerspec` would disarm the timer rather than have it
+         * expire straight away...
+         */
+        auto const timerval = convert_to_itimerspec(
+            std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         duration),
+                     std::chrono::nanoseconds(1)));
+
+        auto arm = [timerval](int fd) noexcept -> std::error_code {
+            if (timerfd_settime(fd, 0, &timerval, nullptr) < 0)
+                return std::error_code { errno, std::system_category() };
+
+            return {};
+        };
+
+        return IoSender<TimerExpiryOrEventOperation,
+                        TimerOrEventIoResult,
+                        decltype(arm)> {
+            ctx_, fd_.value(), false, std::move(arm), {}
+        };
     }
 
     template <typename Rep, typename Period, typename F>
@@ -79,15 +128,18 @@ struct Timer : IoObject
             ctx,
             fd_val,
             [fd = std::move(fd), f = std::move(completion)](
-                auto&& result) mutable { std::move(f)(std::move(result)); });
+                auto&& result) mutable { std::move(f)(std::move(result)); },
+            ctx.get_allocator());
     }
 
 private:
-    template <typename F>
-    static auto
-    queue_timer_operation(Context const& ctx, int fd, F&& completion) -> void
+    template <typename F, typename Alloc>
+    static auto queue_timer_operation(Context const& ctx,
+                                      int fd,
+                                      F&& completion,
+                                      Alloc const& fallback) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, fallback);
 
         auto* op =
             make_async_io_operation(timer_expiry_operation,
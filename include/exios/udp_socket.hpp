@@ -2,12 +2,15 @@
 #define EXIOS_UDP_SOCKET_HPP_INCLUDED
 
 #include "exios/buffer_view.hpp"
+#include "exios/contracts.hpp"
 #include "exios/io.hpp"
+#include "exios/io_awaitable.hpp"
 #include "exios/io_object.hpp"
 #include "exios/utils.hpp"
 #include "exios/work.hpp"
 #include <cstdint>
 #include <netinet/in.h>
+#include <span>
 namespace exios
 {
 
@@ -29,7 +32,7 @@ struct UdpSocket : IoObject
         addr.sin_addr.s_addr = reverse_byte_order(parse_ipv4(address));
         addr.sin_port = reverse_byte_order(port);
 
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op = make_async_io_operation(
             net_connect_operation,
@@ -44,6 +47,20 @@ struct UdpSocket : IoObject
 
     auto bind(std::uint16_t port, std::string_view address = "0.0.0.0") -> void;
 
+    /*!
+     * Sets `UDP_GRO`, allowing the kernel to coalesce datagrams from the
+     * same source into one larger payload; See `receive_coalesced()`.
+     * Throws a ::std::system_error if the option can't be set.
+     */
+    auto enable_gro(bool enabled = true) -> void;
+
+    /*!
+     * Sets `UDP_SEGMENT`, so every send on the socket is split into
+     * datagrams of `segment_size` bytes by UDP GSO; `0` turns this off.
+     * Throws a ::std::system_error if the option can't be set.
+     */
+    auto set_gso_segment_size(std::uint16_t segment_size) -> void;
+
     /**
      * Completes with:
      *   Result<std::tuple<std::size_t, sockaddr_in>, std::error_code>
@@ -51,7 +68,7 @@ struct UdpSocket : IoObject
     template <typename Completion>
     auto receive_from(BufferView buffer, Completion&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op = make_async_io_operation(
             net_receive_from_operation,
@@ -61,7 +78,7 @@ struct UdpSocket : IoObject
             fd_.value(),
             buffer);
 
-        schedule_io(op);
+        schedule_speculative_io(op);
     }
 
     /**
@@ -79,7 +96,7 @@ struct UdpSocket : IoObject
         addr.sin_addr.s_addr = reverse_byte_order(parse_ipv4(address));
         addr.sin_port = reverse_byte_order(port);
 
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op = make_async_io_operation(
             net_send_to_operation,
@@ -90,7 +107,7 @@ struct UdpSocket : IoObject
             buffer,
             addr);
 
-        schedule_io(op);
+        schedule_speculative_io(op);
     }
 
     /**
@@ -109,7 +126,7 @@ struct UdpSocket : IoObject
     template <typename F>
     auto read(BufferView buffer, F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op = make_async_io_operation(
             read_operation,
@@ -119,7 +136,7 @@ struct UdpSocket : IoObject
             fd_.value(),
             buffer);
 
-        schedule_io(op);
+        schedule_speculative_io(op);
     }
 
     /**
@@ -138,7 +155,7 @@ struct UdpSocket : IoObject
     template <typename F>
     auto write(ConstBufferView buffer, F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op = make_async_io_operation(
             write_operation,
@@ -148,7 +165,270 @@ struct UdpSocket : IoObject
             fd_.value(),
             buffer);
 
-        schedule_io(op);
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Sends `buffer` as a train of datagrams of `segment_size` bytes (the
+     * last may be shorter) to `address`, with a single `sendmsg()`; The
+     * kernel, or the NIC, splits it up with UDP GSO. Upon completion,
+     * `completion` is invoked with a ::exios::IoResult holding the number
+     * of bytes sent.
+     *
+     * *NOTE*: `buffer` may hold at most 64 segments, and mustn't exceed
+     * the maximum size of a UDP payload.
+     */
+    template <typename F>
+    auto send_segmented_to(ConstBufferView buffer,
+                           std::uint16_t segment_size,
+                           std::string_view address,
+                           std::uint16_t port,
+                           F&& completion) -> void
+    {
+        sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = reverse_byte_order(parse_ipv4(address));
+        addr.sin_port = reverse_byte_order(port);
+
+        send_segmented(buffer, segment_size, addr, std::move(completion));
+    }
+
+    /*!
+     * As `send_segmented_to()`, but to the socket's peer.
+     *
+     * **NOTE: This member can only be used after a successful call to
+     * `connect()`**
+     */
+    template <typename F>
+    auto send_segmented(ConstBufferView buffer,
+                        std::uint16_t segment_size,
+                        F&& completion) -> void
+    {
+        send_segmented(
+            buffer, segment_size, sockaddr_in {}, std::move(completion));
+    }
+
+    /*!
+     * Receives a single datagram, which may be several coalesced by UDP
+     * GRO if `enable_gro()` has been called. Upon completion,
+     * `completion` is invoked with a ::exios::ReceiveCoalescedResult; Its
+     * `segment_size` gives the size of the coalesced datagrams, so the
+     * payload can be split back up.
+     *
+     * *NOTE*: `buffer` should be large enough for a coalesced payload
+     * (up to 64KiB), otherwise it's truncated.
+     */
+    template <typename F>
+    auto receive_coalesced(BufferView buffer, F&& completion) -> void
+    {
+        auto const alloc = select_allocator(completion, get_allocator());
+
+        auto* op = make_async_io_operation(
+            net_receive_coalesced_operation,
+            wrap_work(std::move(completion), get_context()),
+            alloc,
+            ctx_,
+            fd_.value(),
+            buffer);
+
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Receives as many datagrams as are queued on the socket, up to one
+     * per slot, with `recvmmsg()`; The operation waits only until at least
+     * one has arrived. Upon completion, `completion` is invoked with a
+     * ::exios::IoResult holding the number of slots filled, each of which
+     * holds its datagram's size and source address. An error that comes
+     * after some datagrams were received is dropped.
+     *
+     * *NOTE*: Both `slots` and the buffers they refer to must live until
+     * `completion` is called.
+     */
+    template <typename F>
+    auto receive_batch(std::span<DatagramSlot> slots, F&& completion) -> void
+    {
+        EXIOS_EXPECT(!slots.empty());
+        auto const alloc = select_allocator(completion, get_allocator());
+
+        auto* op = make_async_io_operation(
+            net_receive_batch_operation,
+            wrap_work(std::move(completion), get_context()),
+            alloc,
+            ctx_,
+            fd_.value(),
+            slots);
+
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Sends each of `datagrams`, with as few calls to `sendmmsg()` as
+     * possible. The operation stays queued until they've all been sent.
+     * Upon completion, `completion` is invoked with a ::exios::IoResult
+     * holding the number of datagrams sent; Fewer than requested if an
+     * error or cancellation comes after some were sent, in which case the
+     * error or cancellation is dropped.
+     *
+     * *NOTE*: Both `datagrams` and the buffers they refer to must live
+     * until `completion` is called.
+     */
+    template <typename F>
+    auto send_batch(std::span<Datagram const> datagrams, F&& completion)
+        -> void
+    {
+        auto const alloc = select_allocator(completion, get_allocator());
+
+        auto* op = make_async_io_operation(
+            net_send_batch_operation,
+            wrap_work(std::move(completion), get_context()),
+            alloc,
+            ctx_,
+            fd_.value(),
+            datagrams);
+
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Awaitable form of `connect()`; Resumes with a ::exios::ConnectResult.
+     */
+    [[nodiscard]] auto async_connect(std::string_view address,
+                                     std::uint16_t port)
+    {
+        return make_io_awaitable<ConnectResult>(
+            get_allocator(),
+            [this, address, port](auto&& completion) {
+                connect(address, port, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `receive_from()`; Resumes with a
+     * ::exios::ReceiveFromResult.
+     */
+    [[nodiscard]] auto async_receive_from(BufferView buffer)
+    {
+        return make_io_awaitable<ReceiveFromResult>(
+            get_allocator(),
+            [this, buffer](auto&& completion) {
+                receive_from(buffer, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `send_to()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_send_to(ConstBufferView buffer,
+                                     std::string_view address,
+                                     std::int16_t port)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffer, address, port](auto&& completion) {
+                send_to(buffer, address, port, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `send_segmented_to()`; Resumes with a
+     * ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_send_segmented_to(ConstBufferView buffer,
+                                               std::uint16_t segment_size,
+                                               std::string_view address,
+                                               std::uint16_t port)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffer, segment_size, address, port](auto&& completion) {
+                send_segmented_to(
+                    buffer, segment_size, address, port, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `receive_coalesced()`; Resumes with a
+     * ::exios::ReceiveCoalescedResult.
+     */
+    [[nodiscard]] auto async_receive_coalesced(BufferView buffer)
+    {
+        return make_io_awaitable<ReceiveCoalescedResult>(
+            get_allocator(),
+            [this, buffer](auto&& completion) {
+                receive_coalesced(buffer, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `receive_batch()`; Resumes with a
+     * ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_receive_batch(std::span<DatagramSlot> slots)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, slots](auto&& completion) {
+                receive_batch(slots, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `send_batch()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_send_batch(std::span<Datagram const> datagrams)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, datagrams](auto&& completion) {
+                send_batch(datagrams, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `read()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_read(BufferView buffer)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffer](auto&& completion) {
+                read(buffer, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `write()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_write(ConstBufferView buffer)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffer](auto&& completion) {
+                write(buffer, std::move(completion));
+            });
+    }
+
+private:
+    template <typename F>
+    auto send_segmented(ConstBufferView buffer,
+                        std::uint16_t segment_size,
+                        sockaddr_in const& addr,
+                        F&& completion) -> void
+    {
+        auto const alloc = select_allocator(completion, get_allocator());
+
+        auto* op = make_async_io_operation(
+            net_send_segmented_operation,
+            wrap_work(std::move(completion), get_context()),
+            alloc,
+            ctx_,
+            fd_.value(),
+            buffer,
+            addr,
+            segment_size);
+
+        schedule_speculative_io(op);
     }
 };
 
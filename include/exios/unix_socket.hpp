@@ -4,9 +4,13 @@
 #include "exios/alloc_utils.hpp"
 #include "exios/context.hpp"
 #include "exios/io.hpp"
+#include "exios/io_awaitable.hpp"
 #include "exios/io_object.hpp"
+#include <cstddef>
+#include <span>
 #include <string_view>
 #include <sys/socket.h>
+#include <sys/types.h>
 #include <sys/un.h>
 
 namespace exios
@@ -21,7 +25,7 @@ struct UnixSocket : IoObject
     template <typename F>
     auto connect(std::string_view name, F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op =
             make_async_io_operation(unix_connect_operation,
@@ -47,7 +51,7 @@ struct UnixSocket : IoObject
     template <typename F>
     auto read(BufferView buffer, F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op =
             make_async_io_operation(read_operation,
@@ -57,7 +61,7 @@ struct UnixSocket : IoObject
                                     fd_.value(),
                                     buffer);
 
-        schedule_io(op);
+        schedule_speculative_io(op);
     }
 
     /**
@@ -70,7 +74,7 @@ struct UnixSocket : IoObject
     template <typename F>
     auto receive_message(msghdr msg, F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op =
             make_async_io_operation(receive_message_operation,
@@ -80,13 +84,13 @@ struct UnixSocket : IoObject
                                     fd_.value(),
                                     msg);
 
-        schedule_io(op);
+        schedule_speculative_io(op);
     }
 
     template <typename F>
     auto write(ConstBufferView buffer, F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op =
             make_async_io_operation(write_operation,
@@ -96,13 +100,35 @@ struct UnixSocket : IoObject
                                     fd_.value(),
                                     buffer);
 
-        schedule_io(op);
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * The same interface as ::exios::TcpSocket::send_zerocopy, for code
+     * that's generic over the socket type. Unix sockets don't support
+     * `MSG_ZEROCOPY`; The data is always copied by an ordinary `write()`,
+     * so `on_released` is invoked as soon as `on_sent` returns.
+     */
+    template <typename F, typename G>
+    auto send_zerocopy(ConstBufferView buffer, F&& on_sent, G&& on_released)
+        -> void
+    {
+        write(buffer,
+              [on_sent = std::move(on_sent),
+               on_released = std::move(on_released)](IoResult result) mutable {
+                  auto released = result ? ZerocopyReleaseResult {}
+                                         : ZerocopyReleaseResult {
+                                               result_error(result.error())
+                                           };
+                  on_sent(std::move(result));
+                  on_released(std::move(released));
+              });
     }
 
     template <typename F>
     auto send_message(msghdr msg, F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op =
             make_async_io_operation(send_message_operation,
@@ -112,7 +138,365 @@ struct UnixSocket : IoObject
                                     fd_.value(),
                                     msg);
 
-        schedule_io(op);
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Reads into each of `buffers` in turn, with a single `readv()`.
+     * Upon completion, `completion` is invoked with a ::exios::IoResult
+     * holding the total number of bytes read.
+     *
+     * *NOTE*: Both `buffers` and the memory it refers to must live until
+     * `completion` is called.
+     */
+    template <typename F>
+    auto read_some(std::span<BufferView const> buffers, F&& completion)
+        -> void
+    {
+        auto const alloc = select_allocator(completion, get_allocator());
+
+        auto* op =
+            make_async_io_operation(read_some_operation,
+                                    wrap_work(std::move(completion), ctx_),
+                                    alloc,
+                                    ctx_,
+                                    fd_.value(),
+                                    buffers);
+
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Writes each of `buffers` in turn, with a single `writev()`. Upon
+     * completion, `completion` is invoked with a ::exios::IoResult
+     * holding the total number of bytes written.
+     *
+     * *NOTE*: Both `buffers` and the memory it refers to must live until
+     * `completion` is called.
+     */
+    template <typename F>
+    auto write_some(std::span<ConstBufferView const> buffers, F&& completion)
+        -> void
+    {
+        auto const alloc = select_allocator(completion, get_allocator());
+
+        auto* op =
+            make_async_io_operation(write_some_operation,
+                                    wrap_work(std::move(completion), ctx_),
+                                    alloc,
+                                    ctx_,
+                                    fd_.value(),
+                                    buffers);
+
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Reads until `buffer` is full, with a single operation that stays
+     * queued across partial reads. Upon completion, `completion` is
+     * invoked with a ::exios::IoResult holding the number of bytes read;
+     * This is only less than `buffer.size` if the peer closed the
+     * connection, or if an error or cancellation came after part of the
+     * buffer was read. In that case the error, or the cancellation, is
+     * dropped: The result can't be told apart from the peer closing the
+     * connection, and an error the failed read consumed, such as a
+     * connection reset, isn't reported to the next operation either.
+     *
+     * *NOTE*: The memory `buffer` points to must live until `completion`
+     * is called.
+     */
+    template <typename F>
+    auto read_exactly(BufferView buffer, F&& completion) -> void
+    {
+        auto const alloc = select_allocator(completion, get_allocator());
+
+        auto* op =
+            make_async_io_operation(read_exactly_operation,
+                                    wrap_work(std::move(completion), ctx_),
+                                    alloc,
+                                    ctx_,
+                                    fd_.value(),
+                                    buffer);
+
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Writes the whole of `buffer`, with a single operation that stays
+     * queued across partial writes. Upon completion, `completion` is
+     * invoked with a ::exios::IoResult holding the number of bytes
+     * written; As with `read_exactly()`, this falls short if an error or
+     * cancellation comes after part of the buffer was written, and the
+     * error or cancellation is then dropped.
+     *
+     * *NOTE*: The memory `buffer` points to must live until `completion`
+     * is called.
+     */
+    template <typename F>
+    auto write_all(ConstBufferView buffer, F&& completion) -> void
+    {
+        auto const alloc = select_allocator(completion, get_allocator());
+
+        auto* op =
+            make_async_io_operation(write_all_operation,
+                                    wrap_work(std::move(completion), ctx_),
+                                    alloc,
+                                    ctx_,
+                                    fd_.value(),
+                                    buffer);
+
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Sends `count` bytes of the file `file_fd`, starting at `offset`,
+     * with `sendfile()`; The data is copied by the kernel without passing
+     * through a userspace buffer. The operation stays queued until the
+     * whole range has been sent. Upon completion, `completion` is invoked
+     * with a ::exios::IoResult holding the number of bytes sent; This is
+     * only less than `count` if the file ends first, or if an error or
+     * cancellation comes after part of the range was sent. As with
+     * `write_all()`, the error or cancellation is then dropped, so a
+     * short result doesn't say which of these happened.
+     *
+     * `file_fd`'s own offset isn't changed, and it must stay open until
+     * `completion` is called.
+     *
+     * *NOTE*: The kernel reads the file while the context's I/O scheduler
+     * is locked, so a file that isn't already in the page cache holds up
+     * other operations until the disk read completes. Large or cold files
+     * are best read ahead first (E.g. with `readahead()`).
+     */
+    template <typename F>
+    auto transfer_file(int file_fd,
+                       off_t offset,
+                       std::size_t count,
+                       F&& completion) -> void
+    {
+        auto const alloc = select_allocator(completion, get_allocator());
+
+        auto* op =
+            make_async_io_operation(transfer_file_operation,
+                                    wrap_work(std::move(completion), ctx_),
+                                    alloc,
+                                    ctx_,
+                                    fd_.value(),
+                                    file_fd,
+                                    offset,
+                                    count);
+
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Awaitable form of `connect()`; Resumes with a ::exios::ConnectResult.
+     */
+    [[nodiscard]] auto async_connect(std::string_view name)
+    {
+        return make_io_awaitable<ConnectResult>(
+            get_allocator(),
+            [this, name](auto&& completion) {
+                connect(name, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `read()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_read(BufferView buffer)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffer](auto&& completion) {
+                read(buffer, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `receive_message()`; Resumes with a
+     * ::exios::ReceiveMessageResult.
+     */
+    [[nodiscard]] auto async_receive_message(msghdr msg)
+    {
+        return make_io_awaitable<ReceiveMessageResult>(
+            get_allocator(),
+            [this, msg](auto&& completion) {
+                receive_message(msg, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `write()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_write(ConstBufferView buffer)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffer](auto&& completion) {
+                write(buffer, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `send_message()`; Resumes with a
+     * ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_send_message(msghdr msg)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, msg](auto&& completion) {
+                send_message(msg, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `read_some()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_read_some(std::span<BufferView const> buffers)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffers](auto&& completion) {
+                read_some(buffers, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `write_some()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto
+    async_write_some(std::span<ConstBufferView const> buffers)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffers](auto&& completion) {
+                write_some(buffers, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `read_exactly()`; Resumes with a
+     * ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_read_exactly(BufferView buffer)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffer](auto&& completion) {
+                read_exactly(buffer, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `write_all()`; Resumes with a ::exios::IoResult.
+     */
+    [[nodiscard]] auto async_write_all(ConstBufferView buffer)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, buffer](auto&& completion) {
+                write_all(buffer, std::move(completion));
+            });
+    }
+
+    /*!
+     * Awaitable form of `transfer_file()`; Resumes with a
+     * ::exios::IoResult.
+     */
+    [[nodiscard]] auto
+    async_transfer_file(int file_fd, off_t offset, std::size_t count)
+    {
+        return make_io_awaitable<IoResult>(
+            get_allocator(),
+            [this, file_fd, offset, count](auto&& completion) {
+                transfer_file(file_fd, offset, count, std::move(completion));
+            });
+    }
+
+    /*!
+     * Sender form of `connect()`; Completes with no value.
+     */
+    [[nodiscard]] auto connect_sender(std::string_view name)
+    {
+        return make_io_sender<ConnectResult>(
+            unix_connect_operation, ctx_, fd_.value(), false, name);
+    }
+
+    /*!
+     * Sender form of `read()`; Completes with the number of bytes read.
+     */
+    [[nodiscard]] auto read_sender(BufferView buffer)
+    {
+        return make_io_sender<IoResult>(
+            read_operation, ctx_, fd_.value(), true, buffer);
+    }
+
+    /*!
+     * Sender form of `write()`; Completes with the number of bytes
+     * written.
+     */
+    [[nodiscard]] auto write_sender(ConstBufferView buffer)
+    {
+        return make_io_sender<IoResult>(
+            write_operation, ctx_, fd_.value(), true, buffer);
+    }
+
+    /*!
+     * Sender form of `read_some()`; Completes with the number of bytes
+     * read.
+     */
+    [[nodiscard]] auto read_some_sender(std::span<BufferView const> buffers)
+    {
+        return make_io_sender<IoResult>(
+            read_some_operation, ctx_, fd_.value(), true, buffers);
+    }
+
+    /*!
+     * Sender form of `write_some()`; Completes with the number of bytes
+     * written.
+     */
+    [[nodiscard]] auto
+    write_some_sender(std::span<ConstBufferView const> buffers)
+    {
+        return make_io_sender<IoResult>(
+            write_some_operation, ctx_, fd_.value(), true, buffers);
+    }
+
+    /*!
+     * Sender form of `read_exactly()`; Completes with the number of bytes
+     * read.
+     */
+    [[nodiscard]] auto read_exactly_sender(BufferView buffer)
+    {
+        return make_io_sender<IoResult>(
+            read_exactly_operation, ctx_, fd_.value(), true, buffer);
+    }
+
+    /*!
+     * Sender form of `write_all()`; Completes with the number of bytes
+     * written.
+     */
+    [[nodiscard]] auto write_all_sender(ConstBufferView buffer)
+    {
+        return make_io_sender<IoResult>(
+            write_all_operation, ctx_, fd_.value(), true, buffer);
+    }
+
+    /*!
+     * Sender form of `transfer_file()`; Completes with the number of bytes
+     * sent.
+     */
+    [[nodiscard]] auto
+    transfer_file_sender(int file_fd, off_t offset, std::size_t count)
+    {
+        return make_io_sender<IoResult>(transfer_file_operation,
+                                        ctx_,
+                                        fd_.value(),
+                                        true,
+                                        file_fd,
+                                        offset,
+                                        count);
     }
 
 private:
@@ -127,7 +511,7 @@ struct UnixSocketAcceptor : IoObject
     template <typename F>
     auto accept(UnixSocket& target, F&& completion) -> void
     {
-        auto const alloc = select_allocator(completion);
+        auto const alloc = select_allocator(completion, get_allocator());
 
         auto* op = make_async_io_operation(
             unix_accept_operation,
@@ -147,7 +531,31 @@ struct UnixSocketAcceptor : IoObject
             ctx_,
             fd_.value());
 
-        schedule_io(op);
+        schedule_speculative_io(op);
+    }
+
+    /*!
+     * Awaitable form of `accept()`; Resumes with a
+     * `Result<std::error_code>`.
+     */
+    [[nodiscard]] auto async_accept(UnixSocket& target)
+    {
+        return make_io_awaitable<Result<std::error_code>>(
+            get_allocator(),
+            [this, &target](auto&& completion) {
+                accept(target, std::move(completion));
+            });
+    }
+
+    /*!
+     * Sender form of `accept()`; Completes with the accepted
+     * ::exios::UnixSocket.
+     */
+    [[nodiscard]] auto accept_sender()
+    {
+        return then(make_io_sender<AcceptResult>(
+                        unix_accept_operation, ctx_, fd_.value(), true),
+                    [ctx = ctx_](int fd) { return UnixSocket { ctx, fd }; });
     }
 
 private:
@@ -1,26 +1,42 @@
 #include "exios/async_io_operation.hpp"
+#include "exios/contracts.hpp"
 
 namespace exios
 {
-AsyncIoOperation::AsyncIoOperation(Context ctx,
+AsyncIoOperation::AsyncIoOperation(Thunk thunk,
+                                   Context ctx,
                                    int fd,
-                                   bool is_read_operation) noexcept
-    : ctx_ { ctx }
+                                   bool is_read_operation,
+                                   bool is_error_queue_operation) noexcept
+    : AnyAsyncOperation { thunk }
+    , ctx_ { ctx }
     , fd_ { fd }
-    , is_read_ { is_read_operation }
-    , is_cancelled_ { false }
+    , flags_ { static_cast<std::uint8_t>(
+          (is_read_operation ? kRead : 0) |
+          (is_error_queue_operation ? kErrorQueue : 0)) }
 {
 }
 
+auto AsyncIoOperation::fail(int error) noexcept -> void
+{
+    auto const completed = complete_submission(-error);
+    EXIOS_EXPECT(completed);
+}
+
 auto AsyncIoOperation::cancelled() const noexcept -> bool
 {
-    return is_cancelled_;
+    return (flags_ & kCancelled) != 0;
 }
 
 auto AsyncIoOperation::cancel() noexcept -> void
 {
-    do_cancel();
-    is_cancelled_ = true;
+    static_cast<void>(perform(OperationAction::cancel));
+    flags_ |= kCancelled;
+}
+
+auto AsyncIoOperation::request_cancel() noexcept -> void
+{
+    flags_ |= kCancelled;
 }
 
 auto AsyncIoOperation::get_context() noexcept -> Context& { return ctx_; }
@@ -29,7 +45,12 @@ auto AsyncIoOperation::get_fd() const noexcept -> int { return fd_; }
 
 auto AsyncIoOperation::is_read_operation() const noexcept -> bool
 {
-    return is_read_;
+    return (flags_ & kRead) != 0;
+}
+
+auto AsyncIoOperation::is_error_queue_operation() const noexcept -> bool
+{
+    return (flags_ & kErrorQueue) != 0;
 }
 
 } // namespace exios
@@ -1,6 +1,7 @@
 #include "exios/context.hpp"
 #include "exios/async_operation.hpp"
 #include "exios/context_thread.hpp"
+#include "exios/execution.hpp"
 #include <memory>
 
 namespace exios
@@ -22,4 +23,20 @@ auto Context::io_scheduler() noexcept -> IoScheduler&
     return thread_->io_scheduler();
 }
 
+auto Context::get_scheduler() const noexcept -> Scheduler
+{
+    return Scheduler { *this };
+}
+
+auto Context::recycling_pool() const noexcept -> RecyclingPool&
+{
+    return thread_->recycling_pool();
+}
+
+auto Context::get_allocator() const noexcept
+    -> std::pmr::polymorphic_allocator<std::byte>
+{
+    return thread_->get_allocator();
+}
+
 } // namespace exios
@@ -3,16 +3,23 @@
 #include "exios/contracts.hpp"
 #include "exios/intrusive_list.hpp"
 #include "exios/scope_guard.hpp"
+#include <algorithm>
 #include <cstddef>
 #include <limits>
+#include <mutex>
+#include <utility>
 
 namespace
 {
 
 struct SentinelAsyncOperation final : exios::AnyAsyncOperation
 {
-    auto dispatch() -> void override {}
-    auto discard() noexcept -> void override {}
+    SentinelAsyncOperation() noexcept
+        : AnyAsyncOperation { [](AnyAsyncOperation&,
+                                 exios::OperationAction,
+                                 void*) { return true; } }
+    {
+    }
 };
 
 auto poll_sentinel() -> exios::AnyAsyncOperation*
@@ -26,15 +33,30 @@ auto poll_sentinel() -> exios::AnyAsyncOperation*
 namespace exios
 {
 
+struct ContextThread::Runner
+{
+    ContextThread const* owner;
+    Runner* previous;
+    std::mutex mutex {};
+    IntrusiveList<AnyAsyncOperation> queue {};
+    std::size_t size { 0 };
+};
+
 ContextThread::ContextThread() noexcept
     : io_scheduler_(*this)
 {
 }
 
+ContextThread::ContextThread(IoBackend backend,
+                             std::pmr::memory_resource* fd_table_resource)
+    : io_scheduler_(*this, backend, fd_table_resource)
+{
+}
+
 ContextThread::~ContextThread()
 {
-    std::lock_guard lock { data_mutex_ };
-    drain_list(completion_queue_, [&](auto&& item) noexcept {
+    auto items = completion_queue_.take_all();
+    drain_list(items, [&](auto&& item) noexcept {
         /* Ignore the poll sentinel. This will be cleaned up automatically
          */
         if (std::addressof(item) != poll_sentinel()) {
@@ -53,17 +75,36 @@ auto ContextThread::release_work() noexcept -> void
 {
     auto const prev = remaining_count_.fetch_sub(1);
     EXIOS_EXPECT(prev > 0);
+
+    /* Every running thread must see the count reach zero...
+     */
     io_scheduler_.wake();
-    cvar_.notify_all();
+    notify(true);
 }
 
 auto ContextThread::post(AnyAsyncOperation* op) noexcept -> void
 {
-    std::lock_guard lock { data_mutex_ };
+    /* Completions posted by a runner stay with it. We only wake another
+     * runner when there's more than one queued, so there's something
+     * worth stealing...
+     */
+    if (auto* runner = current_runner(); runner) {
+        if (push_local(*runner, op))
+            static_cast<void>(notify());
+
+        return;
+    }
+
+    /* Posting from elsewhere never blocks; The completion queue is
+     * lock-free...
+     */
     completion_queue_.push_back(op);
-    EXIOS_EXPECT(!completion_queue_.empty());
-    io_scheduler_.wake();
-    cvar_.notify_all();
+
+    /* Prefer a sleeping follower; The polling thread only needs waking
+     * if there's no-one else to run the completion...
+     */
+    if (!notify())
+        io_scheduler_.wake();
 }
 
 auto ContextThread::get_context() const noexcept -> Context
@@ -71,27 +112,178 @@ auto ContextThread::get_context() const noexcept -> Context
     return Context { const_cast<ContextThread&>(*this) };
 }
 
-auto ContextThread::run_once() -> std::size_t
+auto ContextThread::active_runner() noexcept -> Runner*&
+{
+    thread_local Runner* runner = nullptr;
+    return runner;
+}
+
+auto ContextThread::current_runner() const noexcept -> Runner*
 {
-    IntrusiveList<AnyAsyncOperation> tmp;
+    /* Each nested call to `run()` on this thread adds a runner...
+     */
+    for (auto* runner = active_runner(); runner; runner = runner->previous) {
+        if (runner->owner == this)
+            return runner;
+    }
+
+    return nullptr;
+}
 
+auto ContextThread::retire_runner(Runner& runner) noexcept -> void
+{
     {
-        std::lock_guard lock { data_mutex_ };
-        static_cast<void>(tmp.splice(tmp.end(), completion_queue_));
-        EXIOS_EXPECT(completion_queue_.empty());
+        std::lock_guard lock { runners_mutex_ };
+        runners_.erase(std::find(runners_.begin(), runners_.end(), &runner));
     }
 
-    EXIOS_SCOPE_GUARD([this] { cvar_.notify_all(); });
+    IntrusiveList<AnyAsyncOperation> leftover;
+    std::size_t count = 0;
 
-    EXIOS_SCOPE_GUARD([&] {
-        if (!tmp.empty()) {
-            std::lock_guard lock { data_mutex_ };
-            /* If an exception is thrown then we must put all
-             * unprocessed completions back onto the queue...
-             */
-            static_cast<void>(
-                completion_queue_.splice(completion_queue_.begin(), tmp));
+    {
+        std::lock_guard lock { runner.mutex };
+        static_cast<void>(leftover.splice(leftover.end(), runner.queue));
+        count = std::exchange(runner.size, 0);
+    }
+
+    if (count == 0)
+        return;
+
+    /* Anything we didn't get to is handed to the remaining runners...
+     */
+    drain_list(leftover, [&](auto&& item) noexcept {
+        completion_queue_.push_back(&item);
+    });
+    locally_queued_ -= count;
+
+    if (!notify())
+        io_scheduler_.wake();
+}
+
+auto ContextThread::push_local(Runner& runner, AnyAsyncOperation* op) noexcept
+    -> bool
+{
+    bool surplus = false;
+
+    {
+        std::lock_guard lock { runner.mutex };
+        surplus = runner.size > 0;
+        runner.queue.push_back(op);
+        runner.size += 1;
+    }
+
+    locally_queued_ += 1;
+    return surplus;
+}
+
+auto ContextThread::pop_local(Runner& runner) noexcept -> AnyAsyncOperation*
+{
+    std::lock_guard lock { runner.mutex };
+    if (runner.queue.empty())
+        return nullptr;
+
+    auto* op = &runner.queue.front();
+    runner.queue.pop_front();
+    runner.size -= 1;
+    locally_queued_ -= 1;
+
+    return op;
+}
+
+auto ContextThread::steal_into(Runner& runner) noexcept -> std::size_t
+{
+    std::lock_guard runners_lock { runners_mutex_ };
+
+    for (auto* victim : runners_) {
+        if (victim == &runner)
+            continue;
+
+        IntrusiveList<AnyAsyncOperation> stolen;
+        std::size_t count = 0;
+
+        /* We take the newest half of the victim's queue, leaving it the
+         * completions it's about to run...
+         */
+        {
+            std::lock_guard lock { victim->mutex };
+            count = (victim->size + 1) / 2;
+            for (std::size_t i = 0; i < count; ++i) {
+                auto* op = &victim->queue.back();
+                victim->queue.pop_back();
+                stolen.push_front(op);
+            }
+            victim->size -= count;
         }
+
+        if (count == 0)
+            continue;
+
+        std::lock_guard lock { runner.mutex };
+        static_cast<void>(runner.queue.splice(runner.queue.end(), stolen));
+        runner.size += count;
+
+        return count;
+    }
+
+    return 0;
+}
+
+auto ContextThread::run_local(Runner& runner) -> std::size_t
+{
+    /* Completions posted from other threads join our queue, where they
+     * can be stolen like any other...
+     */
+    auto injected = completion_queue_.take_all();
+    std::size_t budget = 0;
+
+    {
+        std::lock_guard lock { runner.mutex };
+        drain_list(injected, [&](auto&& item) noexcept {
+            runner.queue.push_back(&item);
+            runner.size += 1;
+            locally_queued_ += 1;
+        });
+        budget = runner.size;
+    }
+
+    if (budget == 0)
+        budget = steal_into(runner);
+
+    /* Completions are taken one at a time so that the rest can still be
+     * stolen. We only run as many as were queued when we started, so
+     * handlers that keep posting can't starve the poller...
+     */
+    std::size_t num_processed = 0;
+    while (num_processed < budget) {
+        auto* op = pop_local(runner);
+        if (!op)
+            break;
+
+        dispatch(std::move(*op));
+        num_processed += 1;
+    }
+
+    return num_processed;
+}
+
+auto ContextThread::run_shared() -> std::size_t
+{
+    auto tmp = completion_queue_.take_all();
+
+    EXIOS_SCOPE_GUARD([&] {
+        /* If an exception is thrown then we must put all unprocessed
+         * completions back onto the queue. They keep their relative
+         * order, but may now run after completions posted since we took
+         * them...
+         */
+        if (tmp.empty())
+            return;
+
+        drain_list(tmp, [&](auto&& item) noexcept {
+            completion_queue_.push_back(&item);
+        });
+        if (!notify())
+            io_scheduler_.wake();
     });
 
     std::size_t num_processed = 0;
@@ -101,41 +293,101 @@ auto ContextThread::run_once() -> std::size_t
         num_processed += 1;
     });
 
-    bool more_completions_ready = false;
+    return num_processed;
+}
 
-    {
-        std::lock_guard lock { data_mutex_ };
-        more_completions_ready = !completion_queue_.empty();
-    }
+auto ContextThread::has_completions() const noexcept -> bool
+{
+    return !completion_queue_.empty() || locally_queued_ > 0;
+}
+
+auto ContextThread::run_once() -> std::size_t
+{
+    auto* runner = current_runner();
+    auto const num_processed = runner ? run_local(*runner) : run_shared();
+
+    bool const more_completions_ready = has_completions();
+
+    /* Only one thread polls at a time; The others follow, running the
+     * completions it produces. The poller gives up its place once it has
+     * finished polling, promoting a follower while it goes on to run
+     * completions itself...
+     */
+    if (!io_scheduler_.empty() && !polling_.exchange(true)) {
+        EXIOS_SCOPE_GUARD([this] {
+            polling_ = false;
+            static_cast<void>(notify());
+        });
 
-    if (!io_scheduler_.empty())
         static_cast<void>(io_scheduler_.poll_once(!more_completions_ready));
+    }
 
     return num_processed;
 }
 
-auto ContextThread::notify() noexcept -> void { cvar_.notify_all(); }
+auto ContextThread::notify(bool all) noexcept -> bool
+{
+    /* A thread about to sleep is counted in `sleepers_` before it reads
+     * `wake_sequence_` and checks for work. So if it isn't counted yet
+     * then it will see whatever we're notifying it of, and if it is then
+     * bumping the sequence stops it from going to sleep...
+     */
+    if (sleepers_ == 0)
+        return false;
+
+    wake_sequence_.fetch_add(1);
+    if (all)
+        wake_sequence_.notify_all();
+    else
+        wake_sequence_.notify_one();
+
+    return true;
+}
+
+auto ContextThread::ready_to_run() const noexcept -> bool
+{
+    return has_completions() || remaining_count_ == 0;
+}
 
 auto ContextThread::run() -> std::size_t
 {
+    Runner runner { .owner = this, .previous = active_runner() };
+
+    {
+        std::lock_guard lock { runners_mutex_ };
+        runners_.push_back(&runner);
+    }
+
+    active_runner() = &runner;
+
+    EXIOS_SCOPE_GUARD([&] {
+        active_runner() = runner.previous;
+        retire_runner(runner);
+    });
+
     std::size_t num_processed = 0;
     while (remaining_count_ > 0) {
-        {
-            std::unique_lock lock { data_mutex_ };
-            if (completion_queue_.empty() && io_scheduler_.empty() &&
-                remaining_count_ > 0) {
-                cvar_.wait(lock, [this] {
-                    return !completion_queue_.empty() ||
-                           !io_scheduler_.empty() || remaining_count_ == 0;
-                });
-            }
+        /* An idle thread blocks in exactly one place; Polling for I/O if
+         * there's any pending and no-one else is polling, or here if
+         * not...
+         */
+        auto const idle = [this] {
+            return !has_completions() && (io_scheduler_.empty() || polling_);
+        };
+
+        if (idle()) {
+            sleepers_ += 1;
+            auto const sequence = wake_sequence_.load();
+            if (idle() && remaining_count_ > 0)
+                wake_sequence_.wait(sequence);
+            sleepers_ -= 1;
         }
 
         num_processed += run_once();
     }
 
     io_scheduler_.wake();
-    cvar_.notify_all();
+    notify(true);
 
     return num_processed;
 }
@@ -145,4 +397,41 @@ auto ContextThread::io_scheduler() noexcept -> IoScheduler&
     return io_scheduler_;
 }
 
+auto ContextThread::get_allocator() const noexcept
+    -> std::pmr::polymorphic_allocator<std::byte>
+{
+    return std::pmr::polymorphic_allocator<std::byte> { default_resource() };
+}
+
+auto ContextThread::default_resource() const noexcept
+    -> std::pmr::memory_resource*
+{
+    return default_resource_.load(std::memory_order_acquire);
+}
+
+auto ContextThread::set_default_resource(
+    std::pmr::memory_resource* resource) noexcept -> void
+{
+    if (resource == nullptr)
+        resource = &pool_;
+
+    default_resource_.store(resource, std::memory_order_release);
+}
+
+auto ContextThread::recycling_pool() noexcept -> RecyclingPool&
+{
+    return pool_;
+}
+
+auto ContextThread::current() noexcept -> ContextThread*
+{
+    auto* runner = active_runner();
+    return runner ? const_cast<ContextThread*>(runner->owner) : nullptr;
+}
+
+auto ContextThread::allocation_stats() const noexcept -> RecyclingPoolStats
+{
+    return pool_.stats();
+}
+
 } // namespace exios
@@ -1,17 +1,136 @@
 #include "exios/io.hpp"
 #include "exios/result.hpp"
+#include <algorithm>
 #include <cerrno>
 #include <cstddef>
 #include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
+#include <poll.h>
+#include <sys/sendfile.h>
 #include <sys/signalfd.h>
+#include <climits>
+#include <cstring>
+#include <linux/errqueue.h>
+#include <span>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <system_error>
 #include <tuple>
 #include <unistd.h>
 
 namespace exios
 {
+namespace
+{
+auto is_would_block(int res) noexcept -> bool
+{
+    return res == -EAGAIN || res == -EWOULDBLOCK;
+}
+
+auto to_error(int res) noexcept -> std::error_code
+{
+    return std::error_code { -res, std::system_category() };
+}
+
+auto prepare_rw(io_uring_sqe& sqe,
+                std::uint8_t opcode,
+                int fd,
+                void const* data,
+                std::size_t size) noexcept -> void
+{
+    sqe = io_uring_sqe {};
+    sqe.opcode = opcode;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(data);
+    sqe.len = static_cast<std::uint32_t>(size);
+    /* -1 means "use the current file position", which is
+     * ignored for sockets, pipes, etc...
+     */
+    sqe.off = static_cast<std::uint64_t>(-1);
+}
+
+auto prepare_msg(io_uring_sqe& sqe,
+                 std::uint8_t opcode,
+                 int fd,
+                 msghdr const* msg) noexcept -> void
+{
+    sqe = io_uring_sqe {};
+    sqe.opcode = opcode;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(msg);
+    sqe.len = 1;
+    sqe.msg_flags = MSG_NOSIGNAL;
+}
+
+auto prepare_connect(io_uring_sqe& sqe,
+                     int fd,
+                     void const* addr,
+                     std::size_t addr_len) noexcept -> void
+{
+    sqe = io_uring_sqe {};
+    sqe.opcode = IORING_OP_CONNECT;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(addr);
+    sqe.off = addr_len;
+}
+
+/* For operations io_uring has no opcode for; We wait for the FD to become
+ * ready, and then perform the I/O from `complete()`...
+ */
+auto prepare_poll(io_uring_sqe& sqe, int fd, std::uint32_t events) noexcept
+    -> void
+{
+    sqe = io_uring_sqe {};
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = events;
+}
+
+/* The views are passed to `readv()` and `writev()` directly, rather than
+ * copying them into an array of `iovec`s...
+ */
+static_assert(sizeof(BufferView) == sizeof(iovec) &&
+              offsetof(BufferView, data) == offsetof(iovec, iov_base) &&
+              offsetof(BufferView, size) == offsetof(iovec, iov_len));
+static_assert(sizeof(ConstBufferView) == sizeof(iovec) &&
+              offsetof(ConstBufferView, data) == offsetof(iovec, iov_base) &&
+              offsetof(ConstBufferView, size) == offsetof(iovec, iov_len));
+
+template <typename View>
+auto as_iovecs(std::span<View const> buffers) noexcept -> iovec const*
+{
+    EXIOS_EXPECT(buffers.size() <= IOV_MAX);
+    return reinterpret_cast<iovec const*>(buffers.data());
+}
+
+auto complete_connect(int res, std::optional<ConnectResult>& result) noexcept
+    -> bool
+{
+    EXIOS_EXPECT(!result);
+    if (is_would_block(res) || res == -EINPROGRESS || res == -EALREADY)
+        return false;
+
+    if (res < 0)
+        result.emplace(result_error(to_error(res)));
+    else
+        result.emplace(ConnectResult {});
+
+    return true;
+}
+
+/* Compares notification IDs as a window, so the comparison still holds
+ * once they wrap around...
+ */
+auto id_precedes(std::uint32_t lhs, std::uint32_t rhs) noexcept -> bool
+{
+    return static_cast<std::int32_t>(lhs - rhs) < 0;
+}
+
+} // namespace
+
 auto perform_read(int fd, BufferView buf) noexcept -> IoResult
 {
     auto const result = ::read(fd, buf.data, buf.size);
@@ -30,6 +149,31 @@ auto perform_write(int fd, ConstBufferView buf) noexcept -> IoResult
     return result_ok(static_cast<std::size_t>(result));
 }
 
+auto perform_read_some(int fd, std::span<BufferView const> buffers) noexcept
+    -> IoResult
+{
+    auto const result = ::readv(fd,
+                                as_iovecs(buffers),
+                                static_cast<int>(buffers.size()));
+    if (result < 0)
+        return result_error(std::error_code { errno, std::system_category() });
+
+    return result_ok(static_cast<std::size_t>(result));
+}
+
+auto perform_write_some(int fd,
+                        std::span<ConstBufferView const> buffers) noexcept
+    -> IoResult
+{
+    auto const result = ::writev(fd,
+                                 as_iovecs(buffers),
+                                 static_cast<int>(buffers.size()));
+    if (result < 0)
+        return result_error(std::error_code { errno, std::system_category() });
+
+    return result_ok(static_cast<std::size_t>(result));
+}
+
 auto perform_receive(int fd, msghdr& buf) noexcept -> ReceiveMessageResult
 {
     auto const result = ::recvmsg(fd, &buf, MSG_DONTWAIT | MSG_NOSIGNAL);
@@ -64,12 +208,29 @@ auto IoOpBase::cancel() noexcept -> void
         result_error(std::make_error_code(std::errc::operation_canceled)));
 }
 
+auto IoOpBase::cancel(std::size_t transferred) noexcept -> void
+{
+    if (transferred == 0)
+        cancel();
+    else
+        result_.emplace(result_ok(transferred));
+}
+
 auto IoOpBase::set_result(IoResult&& r) noexcept -> void
 {
     EXIOS_EXPECT(!result_);
     result_.emplace(std::move(r));
 }
 
+auto IoOpBase::set_partial_result(std::size_t transferred,
+                                  IoResult&& r) noexcept -> void
+{
+    if (transferred > 0)
+        set_result(result_ok(transferred));
+    else
+        set_result(std::move(r));
+}
+
 IoRead::IoRead(BufferView buffer) noexcept
     : buffer_ { buffer }
 {
@@ -85,6 +246,24 @@ auto IoRead::io(int fd) noexcept -> bool
     return true;
 }
 
+auto IoRead::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    prepare_rw(sqe, IORING_OP_READ, fd, buffer_.data, buffer_.size);
+}
+
+auto IoRead::complete(int res) noexcept -> bool
+{
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        set_result(result_error(to_error(res)));
+    else
+        set_result(result_ok(static_cast<std::size_t>(res)));
+
+    return true;
+}
+
 IoWrite::IoWrite(ConstBufferView buffer) noexcept
     : buffer_ { buffer }
 {
@@ -100,273 +279,1309 @@ auto IoWrite::io(int fd) noexcept -> bool
     return true;
 }
 
-UnixConnect::UnixConnect(std::string_view name) noexcept
-    : addr_ {}
+auto IoWrite::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
 {
-    EXIOS_EXPECT(name.size() < sizeof(addr_.sun_path));
-    addr_.sun_family = AF_UNIX;
-    addr_.sun_path[0] = '\0';
-    name.copy(addr_.sun_path + 1, name.size());
+    prepare_rw(sqe, IORING_OP_WRITE, fd, buffer_.data, buffer_.size);
 }
 
-auto UnixConnect::io(int fd) noexcept -> bool
+auto IoWrite::complete(int res) noexcept -> bool
 {
-    EXIOS_EXPECT(!result_);
-    auto const r =
-        ::connect(fd, reinterpret_cast<sockaddr const*>(&addr_), sizeof(addr_));
-    if (r < 0 && (errno == EAGAIN || errno == EINPROGRESS))
+    if (is_would_block(res))
         return false;
 
-    if (r < 0) {
-        result_.emplace(
-            result_error(std::error_code { errno, std::system_category() }));
-    }
-    else {
-        result_.emplace(ConnectResult {});
-    }
+    if (res < 0)
+        set_result(result_error(to_error(res)));
+    else
+        set_result(result_ok(static_cast<std::size_t>(res)));
 
     return true;
 }
 
-auto UnixConnect::cancel() noexcept -> void
+IoReadSome::IoReadSome(std::span<BufferView const> buffers) noexcept
+    : buffers_ { buffers }
 {
-    result_.emplace(
-        result_error(std::make_error_code(std::errc::operation_canceled)));
 }
 
-NetConnect::NetConnect(sockaddr_in addr) noexcept
-    : addr_ { addr }
+auto IoReadSome::io(int fd) noexcept -> bool
 {
+    auto r = perform_read_some(fd, buffers_);
+    if (r.is_error_value() && r.error() == std::errc::operation_would_block)
+        return false;
+
+    set_result(std::move(r));
+    return true;
 }
 
-auto NetConnect::io(int fd) noexcept -> bool
+auto IoReadSome::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
 {
-    EXIOS_EXPECT(!result_);
-    auto const r =
-        ::connect(fd, reinterpret_cast<sockaddr const*>(&addr_), sizeof(addr_));
-    if (r < 0 && (errno == EAGAIN || errno == EINPROGRESS))
+    prepare_rw(
+        sqe, IORING_OP_READV, fd, as_iovecs(buffers_), buffers_.size());
+}
+
+auto IoReadSome::complete(int res) noexcept -> bool
+{
+    if (is_would_block(res))
         return false;
 
-    if (r < 0) {
-        result_.emplace(
-            result_error(std::error_code { errno, std::system_category() }));
-    }
-    else {
-        result_.emplace(ConnectResult {});
-    }
+    if (res < 0)
+        set_result(result_error(to_error(res)));
+    else
+        set_result(result_ok(static_cast<std::size_t>(res)));
 
     return true;
 }
 
-auto NetConnect::cancel() noexcept -> void
+IoWriteSome::IoWriteSome(std::span<ConstBufferView const> buffers) noexcept
+    : buffers_ { buffers }
 {
-    result_.emplace(
-        result_error(std::make_error_code(std::errc::operation_canceled)));
 }
 
-auto UnixAccept::io(int fd) noexcept -> bool
+auto IoWriteSome::io(int fd) noexcept -> bool
 {
-    EXIOS_EXPECT(!result_);
-    auto const r = ::accept(fd, nullptr, nullptr);
-    if (r < 0 && (errno == EAGAIN || errno == EINPROGRESS))
+    auto r = perform_write_some(fd, buffers_);
+    if (r.is_error_value() && r.error() == std::errc::operation_would_block)
         return false;
 
-    if (r < 0) {
-        result_.emplace(
-            result_error(std::error_code { errno, std::system_category() }));
-    }
-    else {
-        result_.emplace(result_ok(r));
-    }
-
+    set_result(std::move(r));
     return true;
 }
 
-auto UnixAccept::cancel() noexcept -> void
+auto IoWriteSome::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
 {
-    result_.emplace(
-        result_error(std::make_error_code(std::errc::operation_canceled)));
+    prepare_rw(
+        sqe, IORING_OP_WRITEV, fd, as_iovecs(buffers_), buffers_.size());
 }
 
-auto TimerExpiryOrEvent::io(int fd) noexcept -> bool
+auto IoWriteSome::complete(int res) noexcept -> bool
 {
-    EXIOS_EXPECT(!result_);
-    auto r = perform_timer_or_event_read(fd);
-    if (r.is_error_value() && (r.error() == std::errc::operation_would_block ||
-                               r.error() == std::errc::operation_in_progress))
+    if (is_would_block(res))
         return false;
 
-    result_.emplace(r);
+    if (res < 0)
+        set_result(result_error(to_error(res)));
+    else
+        set_result(result_ok(static_cast<std::size_t>(res)));
+
     return true;
 }
 
-auto TimerExpiryOrEvent::cancel() noexcept -> void
+IoReadExactly::IoReadExactly(BufferView buffer) noexcept
+    : buffer_ { buffer }
 {
-    result_.emplace(
-        result_error(std::make_error_code(std::errc::operation_canceled)));
 }
 
-EventWrite::EventWrite(std::optional<std::uint64_t> value_to_write) noexcept
-    : value_to_write_ { std::move(value_to_write) }
+auto IoReadExactly::io(int fd) noexcept -> bool
 {
-}
+    while (transferred_ < buffer_.size) {
+        auto r = perform_read(
+            fd,
+            BufferView { static_cast<char*>(buffer_.data) + transferred_,
+                         buffer_.size - transferred_ });
 
-auto EventWrite::io(int fd) noexcept -> bool
-{
-    EXIOS_EXPECT(!result_);
-    std::uint64_t val = value_to_write_.has_value() ? *value_to_write_ : 1;
-    ConstBufferView buffer { .data = &val, .size = sizeof(val) };
-    auto r = perform_write(fd, buffer);
-    if (r.is_error_value() && (r.error() == std::errc::operation_would_block ||
-                               r.error() == std::errc::operation_in_progress))
-        return false;
+        if (r.is_error_value()) {
+            if (r.error() == std::errc::operation_would_block)
+                return false;
 
-    result_.emplace(r);
+            set_partial_result(transferred_, std::move(r));
+            return true;
+        }
+
+        if (r.value() == 0)
+            break;
+
+        transferred_ += r.value();
+    }
+
+    set_result(result_ok(transferred_));
     return true;
 }
 
-auto EventWrite::cancel() noexcept -> void
+auto IoReadExactly::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
 {
-    result_.emplace(
-        result_error(std::make_error_code(std::errc::operation_canceled)));
+    prepare_rw(sqe,
+               IORING_OP_READ,
+               fd,
+               static_cast<char*>(buffer_.data) + transferred_,
+               buffer_.size - transferred_);
 }
 
-auto SignalRead::io(int fd) noexcept -> bool
+auto IoReadExactly::complete(int res) noexcept -> bool
 {
-    EXIOS_EXPECT(!result_);
-    signalfd_siginfo val;
-    BufferView buffer { .data = &val, .size = sizeof(val) };
-    auto r = perform_read(fd, buffer);
-    if (r.is_error_value() && (r.error() == std::errc::operation_would_block ||
-                               r.error() == std::errc::operation_in_progress))
+    if (is_would_block(res))
         return false;
 
-    result_.emplace(result_ok(val));
+    if (res < 0) {
+        set_partial_result(transferred_, result_error(to_error(res)));
+        return true;
+    }
+
+    transferred_ += static_cast<std::size_t>(res);
+    if (res > 0 && transferred_ < buffer_.size)
+        return false;
+
+    set_result(result_ok(transferred_));
     return true;
 }
 
-auto SignalRead::cancel() noexcept -> void
+auto IoReadExactly::cancel() noexcept -> void
 {
-    result_.emplace(
-        result_error(std::make_error_code(std::errc::operation_canceled)));
+    IoOpBase::cancel(transferred_);
 }
 
-SendMessage::SendMessage(msghdr msg) noexcept
-    : msg_ { msg }
+IoWriteAll::IoWriteAll(ConstBufferView buffer) noexcept
+    : buffer_ { buffer }
 {
 }
 
-auto SendMessage::io(int fd) noexcept -> bool
+auto IoWriteAll::io(int fd) noexcept -> bool
 {
-    EXIOS_EXPECT(!result_);
-    auto r = perform_send(fd, msg_);
-    if (!r && (r.error() == std::errc::operation_in_progress ||
-               r.error() == std::errc::operation_would_block))
-        return false;
+    while (transferred_ < buffer_.size) {
+        auto r = perform_write(
+            fd,
+            ConstBufferView {
+                static_cast<char const*>(buffer_.data) + transferred_,
+                buffer_.size - transferred_ });
 
-    result_.emplace(std::move(r));
+        if (r.is_error_value()) {
+            if (r.error() == std::errc::operation_would_block)
+                return false;
+
+            set_partial_result(transferred_, std::move(r));
+            return true;
+        }
+
+        transferred_ += r.value();
+    }
+
+    set_result(result_ok(transferred_));
     return true;
 }
 
-auto SendMessage::cancel() noexcept -> void
+auto IoWriteAll::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
 {
-    result_.emplace(
-        result_error(std::make_error_code(std::errc::operation_canceled)));
+    prepare_rw(sqe,
+               IORING_OP_WRITE,
+               fd,
+               static_cast<char const*>(buffer_.data) + transferred_,
+               buffer_.size - transferred_);
 }
 
-ReceiveMessage::ReceiveMessage(msghdr msg) noexcept
-    : msg_ { msg }
+auto IoWriteAll::complete(int res) noexcept -> bool
 {
-}
+    if (is_would_block(res))
+        return false;
 
-auto ReceiveMessage::io(int fd) noexcept -> bool
-{
-    EXIOS_EXPECT(!result_);
-    auto r = perform_receive(fd, msg_);
-    if (!r && (r.error() == std::errc::operation_in_progress ||
-               r.error() == std::errc::operation_would_block))
+    if (res < 0) {
+        set_partial_result(transferred_, result_error(to_error(res)));
+        return true;
+    }
+
+    transferred_ += static_cast<std::size_t>(res);
+    if (transferred_ < buffer_.size)
         return false;
 
-    result_.emplace(std::move(r));
+    set_result(result_ok(transferred_));
     return true;
 }
 
-auto ReceiveMessage::cancel() noexcept -> void
+auto IoWriteAll::cancel() noexcept -> void
 {
-    result_.emplace(
-        result_error(std::make_error_code(std::errc::operation_canceled)));
+    IoOpBase::cancel(transferred_);
 }
 
-NetSendTo::NetSendTo(ConstBufferView buffer, sockaddr_in addr) noexcept
-    : buffer_ { buffer }
-    , addr_ { addr }
+IoTransferFile::IoTransferFile(int file_fd,
+                               off_t offset,
+                               std::size_t count) noexcept
+    : file_fd_ { file_fd }
+    , offset_ { offset }
+    , count_ { count }
 {
+    EXIOS_EXPECT(file_fd_ >= 0);
+    EXIOS_EXPECT(offset_ >= 0);
 }
 
-auto NetSendTo::io(int fd) noexcept -> bool
+auto IoTransferFile::io(int fd) noexcept -> bool
 {
-    EXIOS_EXPECT(!result_);
-    auto const r = ::sendto(fd,
-                            buffer_.data,
-                            buffer_.size,
-                            0,
-                            reinterpret_cast<sockaddr const*>(&addr_),
-                            sizeof(addr_));
-    if (r < 0 && (errno == EAGAIN || errno == EINPROGRESS))
-        return false;
+    while (transferred_ < count_) {
+        auto offset = offset_ + static_cast<off_t>(transferred_);
+        auto const r =
+            ::sendfile(fd, file_fd_, &offset, count_ - transferred_);
 
-    if (r < 0) {
-        result_.emplace(
-            result_error(std::error_code { errno, std::system_category() }));
-    }
-    else {
-        result_.emplace(result_ok(static_cast<std::size_t>(r)));
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return false;
+
+        if (r < 0) {
+            set_partial_result(
+                transferred_,
+                result_error(
+                    std::error_code { errno, std::system_category() }));
+            return true;
+        }
+
+        /* The file ended before the range did...
+         */
+        if (r == 0)
+            break;
+
+        transferred_ += static_cast<std::size_t>(r);
     }
 
+    set_result(result_ok(transferred_));
     return true;
 }
 
-auto NetSendTo::cancel() noexcept -> void
+auto IoTransferFile::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
 {
-    result_.emplace(
-        result_error(std::make_error_code(std::errc::operation_canceled)));
+    socket_fd_ = fd;
+    prepare_poll(sqe, fd, POLLOUT);
 }
 
-NetReceiveFrom::NetReceiveFrom(BufferView buffer) noexcept
-    : buffer_ { buffer }
+auto IoTransferFile::complete(int res) noexcept -> bool
 {
+    if (res < 0) {
+        set_partial_result(transferred_, result_error(to_error(res)));
+        return true;
+    }
+
+    return io(socket_fd_);
 }
 
-auto NetReceiveFrom::io(int fd) noexcept -> bool
+auto IoTransferFile::cancel() noexcept -> void
 {
-    EXIOS_EXPECT(!result_);
-    sockaddr_in source_addr {};
-    socklen_t source_addr_len = static_cast<socklen_t>(sizeof(source_addr));
-    auto const r = ::recvfrom(fd,
-                              buffer_.data,
-                              buffer_.size,
-                              0,
-                              reinterpret_cast<sockaddr*>(&source_addr),
-                              &source_addr_len);
-    if (r < 0 && (errno == EAGAIN || errno == EINPROGRESS))
+    IoOpBase::cancel(transferred_);
+}
+
+IoSpliceIn::IoSpliceIn(int pipe_fd, std::size_t max) noexcept
+    : pipe_fd_ { pipe_fd }
+    , max_ { max }
+{
+}
+
+auto IoSpliceIn::io(int fd) noexcept -> bool
+{
+    auto const r = ::splice(fd,
+                            nullptr,
+                            pipe_fd_,
+                            nullptr,
+                            max_,
+                            SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
         return false;
 
     if (r < 0) {
-        result_.emplace(
+        set_result(
             result_error(std::error_code { errno, std::system_category() }));
     }
     else {
-        result_.emplace(result_ok(
-            std::make_tuple(static_cast<std::size_t>(r), source_addr)));
+        set_result(result_ok(static_cast<std::size_t>(r)));
     }
 
     return true;
 }
 
-auto NetReceiveFrom::cancel() noexcept -> void
+auto IoSpliceIn::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    fd_ = fd;
+    prepare_poll(sqe, fd, POLLIN);
+}
+
+auto IoSpliceIn::complete(int res) noexcept -> bool
+{
+    if (res < 0) {
+        set_result(result_error(to_error(res)));
+        return true;
+    }
+
+    return io(fd_);
+}
+
+IoSpliceOut::IoSpliceOut(int pipe_fd, std::size_t count) noexcept
+    : pipe_fd_ { pipe_fd }
+    , count_ { count }
+{
+}
+
+auto IoSpliceOut::io(int fd) noexcept -> bool
+{
+    while (transferred_ < count_) {
+        auto const r = ::splice(pipe_fd_,
+                                nullptr,
+                                fd,
+                                nullptr,
+                                count_ - transferred_,
+                                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return false;
+
+        if (r < 0) {
+            set_result(result_error(
+                std::error_code { errno, std::system_category() }));
+            return true;
+        }
+
+        transferred_ += static_cast<std::size_t>(r);
+    }
+
+    set_result(result_ok(transferred_));
+    return true;
+}
+
+auto IoSpliceOut::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    fd_ = fd;
+    prepare_poll(sqe, fd, POLLOUT);
+}
+
+auto IoSpliceOut::complete(int res) noexcept -> bool
+{
+    if (res < 0) {
+        set_result(result_error(to_error(res)));
+        return true;
+    }
+
+    return io(fd_);
+}
+
+UnixConnect::UnixConnect(std::string_view name) noexcept
+    : addr_ {}
+{
+    EXIOS_EXPECT(name.size() < sizeof(addr_.sun_path));
+    addr_.sun_family = AF_UNIX;
+    addr_.sun_path[0] = '\0';
+    name.copy(addr_.sun_path + 1, name.size());
+}
+
+auto UnixConnect::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    auto const r =
+        ::connect(fd, reinterpret_cast<sockaddr const*>(&addr_), sizeof(addr_));
+    if (r < 0 &&
+        (errno == EAGAIN || errno == EINPROGRESS || errno == EALREADY))
+        return false;
+
+    if (r < 0) {
+        result_.emplace(
+            result_error(std::error_code { errno, std::system_category() }));
+    }
+    else {
+        result_.emplace(ConnectResult {});
+    }
+
+    return true;
+}
+
+auto UnixConnect::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    prepare_connect(sqe, fd, &addr_, sizeof(addr_));
+}
+
+auto UnixConnect::complete(int res) noexcept -> bool
+{
+    return complete_connect(res, result_);
+}
+
+auto UnixConnect::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+NetConnect::NetConnect(sockaddr_in addr) noexcept
+    : addr_ { addr }
+{
+}
+
+auto NetConnect::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    auto const r =
+        ::connect(fd, reinterpret_cast<sockaddr const*>(&addr_), sizeof(addr_));
+    if (r < 0 &&
+        (errno == EAGAIN || errno == EINPROGRESS || errno == EALREADY))
+        return false;
+
+    if (r < 0) {
+        result_.emplace(
+            result_error(std::error_code { errno, std::system_category() }));
+    }
+    else {
+        result_.emplace(ConnectResult {});
+    }
+
+    return true;
+}
+
+auto NetConnect::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    prepare_connect(sqe, fd, &addr_, sizeof(addr_));
+}
+
+auto NetConnect::complete(int res) noexcept -> bool
+{
+    return complete_connect(res, result_);
+}
+
+auto NetConnect::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+auto UnixAccept::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    auto const r =
+        ::accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (r < 0 && (errno == EAGAIN || errno == EINPROGRESS))
+        return false;
+
+    if (r < 0) {
+        result_.emplace(
+            result_error(std::error_code { errno, std::system_category() }));
+    }
+    else {
+        result_.emplace(result_ok(r));
+    }
+
+    return true;
+}
+
+auto UnixAccept::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    sqe = io_uring_sqe {};
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = fd;
+    sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+}
+
+auto UnixAccept::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        result_.emplace(result_ok(res));
+
+    return true;
+}
+
+auto UnixAccept::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+auto TimerExpiryOrEvent::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    auto r = perform_timer_or_event_read(fd);
+    if (r.is_error_value() && (r.error() == std::errc::operation_would_block ||
+                               r.error() == std::errc::operation_in_progress))
+        return false;
+
+    result_.emplace(r);
+    return true;
+}
+
+auto TimerExpiryOrEvent::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    prepare_rw(sqe, IORING_OP_READ, fd, &value_, sizeof(value_));
+}
+
+auto TimerExpiryOrEvent::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        result_.emplace(result_ok(value_));
+
+    return true;
+}
+
+auto TimerExpiryOrEvent::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+EventWrite::EventWrite(std::optional<std::uint64_t> value_to_write) noexcept
+    : value_to_write_ { std::move(value_to_write) }
+{
+}
+
+auto EventWrite::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    std::uint64_t val = value_to_write_.has_value() ? *value_to_write_ : 1;
+    ConstBufferView buffer { .data = &val, .size = sizeof(val) };
+    auto r = perform_write(fd, buffer);
+    if (r.is_error_value() && (r.error() == std::errc::operation_would_block ||
+                               r.error() == std::errc::operation_in_progress))
+        return false;
+
+    result_.emplace(r);
+    return true;
+}
+
+auto EventWrite::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    value_ = value_to_write_.has_value() ? *value_to_write_ : 1;
+    prepare_rw(sqe, IORING_OP_WRITE, fd, &value_, sizeof(value_));
+}
+
+auto EventWrite::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        result_.emplace(result_ok(static_cast<std::size_t>(res)));
+
+    return true;
+}
+
+auto EventWrite::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+auto SignalRead::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    signalfd_siginfo val;
+    BufferView buffer { .data = &val, .size = sizeof(val) };
+    auto r = perform_read(fd, buffer);
+    if (r.is_error_value() && (r.error() == std::errc::operation_would_block ||
+                               r.error() == std::errc::operation_in_progress))
+        return false;
+
+    result_.emplace(result_ok(val));
+    return true;
+}
+
+auto SignalRead::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    prepare_rw(sqe, IORING_OP_READ, fd, &info_, sizeof(info_));
+}
+
+auto SignalRead::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        result_.emplace(result_ok(info_));
+
+    return true;
+}
+
+auto SignalRead::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+SendMessage::SendMessage(msghdr msg) noexcept
+    : msg_ { msg }
+{
+}
+
+auto SendMessage::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    auto r = perform_send(fd, msg_);
+    if (!r && (r.error() == std::errc::operation_in_progress ||
+               r.error() == std::errc::operation_would_block))
+        return false;
+
+    result_.emplace(std::move(r));
+    return true;
+}
+
+auto SendMessage::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    prepare_msg(sqe, IORING_OP_SENDMSG, fd, &msg_);
+}
+
+auto SendMessage::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        result_.emplace(result_ok(static_cast<std::size_t>(res)));
+
+    return true;
+}
+
+auto SendMessage::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+ReceiveMessage::ReceiveMessage(msghdr msg) noexcept
+    : msg_ { msg }
+{
+}
+
+auto ReceiveMessage::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    auto r = perform_receive(fd, msg_);
+    if (!r && (r.error() == std::errc::operation_in_progress ||
+               r.error() == std::errc::operation_would_block))
+        return false;
+
+    result_.emplace(std::move(r));
+    return true;
+}
+
+auto ReceiveMessage::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    prepare_msg(sqe, IORING_OP_RECVMSG, fd, &msg_);
+}
+
+auto ReceiveMessage::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        result_.emplace(
+            result_ok(std::make_pair(static_cast<std::size_t>(res), msg_)));
+
+    return true;
+}
+
+auto ReceiveMessage::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+NetSendTo::NetSendTo(ConstBufferView buffer, sockaddr_in addr) noexcept
+    : buffer_ { buffer }
+    , addr_ { addr }
+{
+}
+
+auto NetSendTo::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    auto const r = ::sendto(fd,
+                            buffer_.data,
+                            buffer_.size,
+                            0,
+                            reinterpret_cast<sockaddr const*>(&addr_),
+                            sizeof(addr_));
+    if (r < 0 && (errno == EAGAIN || errno == EINPROGRESS))
+        return false;
+
+    if (r < 0) {
+        result_.emplace(
+            result_error(std::error_code { errno, std::system_category() }));
+    }
+    else {
+        result_.emplace(result_ok(static_cast<std::size_t>(r)));
+    }
+
+    return true;
+}
+
+auto NetSendTo::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    iov_.iov_base = const_cast<void*>(buffer_.data);
+    iov_.iov_len = buffer_.size;
+    msg_ = msghdr {};
+    msg_.msg_name = &addr_;
+    msg_.msg_namelen = sizeof(addr_);
+    msg_.msg_iov = &iov_;
+    msg_.msg_iovlen = 1;
+    prepare_msg(sqe, IORING_OP_SENDMSG, fd, &msg_);
+}
+
+auto NetSendTo::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        result_.emplace(result_ok(static_cast<std::size_t>(res)));
+
+    return true;
+}
+
+auto NetSendTo::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+NetReceiveFrom::NetReceiveFrom(BufferView buffer) noexcept
+    : buffer_ { buffer }
+{
+}
+
+auto NetReceiveFrom::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    sockaddr_in source_addr {};
+    socklen_t source_addr_len = static_cast<socklen_t>(sizeof(source_addr));
+    auto const r = ::recvfrom(fd,
+                              buffer_.data,
+                              buffer_.size,
+                              0,
+                              reinterpret_cast<sockaddr*>(&source_addr),
+                              &source_addr_len);
+    if (r < 0 && (errno == EAGAIN || errno == EINPROGRESS))
+        return false;
+
+    if (r < 0) {
+        result_.emplace(
+            result_error(std::error_code { errno, std::system_category() }));
+    }
+    else {
+        result_.emplace(result_ok(
+            std::make_tuple(static_cast<std::size_t>(r), source_addr)));
+    }
+
+    return true;
+}
+
+auto NetReceiveFrom::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    iov_.iov_base = buffer_.data;
+    iov_.iov_len = buffer_.size;
+    msg_ = msghdr {};
+    msg_.msg_name = &source_addr_;
+    msg_.msg_namelen = sizeof(source_addr_);
+    msg_.msg_iov = &iov_;
+    msg_.msg_iovlen = 1;
+    prepare_msg(sqe, IORING_OP_RECVMSG, fd, &msg_);
+}
+
+auto NetReceiveFrom::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        result_.emplace(result_ok(
+            std::make_tuple(static_cast<std::size_t>(res), source_addr_)));
+
+    return true;
+}
+
+auto NetReceiveFrom::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+NetReceiveBatch::NetReceiveBatch(std::span<DatagramSlot> slots) noexcept
+    : slots_ { slots }
+{
+}
+
+auto NetReceiveBatch::io(int fd) noexcept -> bool
+{
+    std::size_t received = 0;
+
+    while (received < slots_.size()) {
+        auto const count = std::min(kBatchSize, slots_.size() - received);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto& slot = slots_[received + i];
+            headers_[i] = mmsghdr {};
+            headers_[i].msg_hdr.msg_name = &slot.address;
+            headers_[i].msg_hdr.msg_namelen = sizeof(slot.address);
+            headers_[i].msg_hdr.msg_iov =
+                reinterpret_cast<iovec*>(&slot.buffer);
+            headers_[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        auto const r = ::recvmmsg(fd,
+                                  headers_.data(),
+                                  static_cast<unsigned int>(count),
+                                  MSG_DONTWAIT,
+                                  nullptr);
+
+        /* Once we have some datagrams, they're returned and the error is
+         * dropped; One the call consumed, such as an `ECONNREFUSED`
+         * queued on the socket, isn't seen again...
+         */
+        if (r < 0) {
+            if (received > 0)
+                break;
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return false;
+
+            set_result(result_error(
+                std::error_code { errno, std::system_category() }));
+            return true;
+        }
+
+        auto const filled = static_cast<std::size_t>(r);
+        for (std::size_t i = 0; i < filled; ++i) {
+            auto& slot = slots_[received + i];
+            slot.size = headers_[i].msg_len;
+            slot.truncated = (headers_[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        }
+
+        received += filled;
+        if (filled < count)
+            break;
+    }
+
+    set_result(result_ok(received));
+    return true;
+}
+
+auto NetReceiveBatch::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    fd_ = fd;
+    prepare_poll(sqe, fd, POLLIN);
+}
+
+auto NetReceiveBatch::complete(int res) noexcept -> bool
+{
+    if (res < 0) {
+        set_result(result_error(to_error(res)));
+        return true;
+    }
+
+    return io(fd_);
+}
+
+NetSendBatch::NetSendBatch(std::span<Datagram const> datagrams) noexcept
+    : datagrams_ { datagrams }
+{
+}
+
+auto NetSendBatch::io(int fd) noexcept -> bool
+{
+    while (sent_ < datagrams_.size()) {
+        auto const count = std::min(kBatchSize, datagrams_.size() - sent_);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto const& datagram = datagrams_[sent_ + i];
+            headers_[i] = mmsghdr {};
+            if (datagram.address.sin_family != AF_UNSPEC) {
+                headers_[i].msg_hdr.msg_name =
+                    const_cast<sockaddr_in*>(&datagram.address);
+                headers_[i].msg_hdr.msg_namelen = sizeof(datagram.address);
+            }
+            headers_[i].msg_hdr.msg_iov =
+                reinterpret_cast<iovec*>(const_cast<ConstBufferView*>(
+                    &datagram.buffer));
+            headers_[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        auto const r = ::sendmmsg(fd,
+                                  headers_.data(),
+                                  static_cast<unsigned int>(count),
+                                  MSG_DONTWAIT | MSG_NOSIGNAL);
+
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return false;
+
+        if (r < 0) {
+            set_partial_result(
+                sent_,
+                result_error(
+                    std::error_code { errno, std::system_category() }));
+            return true;
+        }
+
+        sent_ += static_cast<std::size_t>(r);
+    }
+
+    set_result(result_ok(sent_));
+    return true;
+}
+
+auto NetSendBatch::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    fd_ = fd;
+    prepare_poll(sqe, fd, POLLOUT);
+}
+
+auto NetSendBatch::complete(int res) noexcept -> bool
+{
+    if (res < 0) {
+        set_partial_result(sent_, result_error(to_error(res)));
+        return true;
+    }
+
+    return io(fd_);
+}
+
+auto NetSendBatch::cancel() noexcept -> void
+{
+    IoOpBase::cancel(sent_);
+}
+
+NetSendSegmented::NetSendSegmented(ConstBufferView buffer,
+                                   sockaddr_in addr,
+                                   std::uint16_t segment_size) noexcept
+    : buffer_ { buffer }
+    , addr_ { addr }
+    , segment_size_ { segment_size }
+{
+    EXIOS_EXPECT(segment_size_ > 0);
+}
+
+auto NetSendSegmented::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    reset_message();
+    auto const r = ::sendmsg(fd, &msg_, MSG_NOSIGNAL);
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        return false;
+
+    if (r < 0) {
+        result_.emplace(
+            result_error(std::error_code { errno, std::system_category() }));
+    }
+    else {
+        result_.emplace(result_ok(static_cast<std::size_t>(r)));
+    }
+
+    return true;
+}
+
+auto NetSendSegmented::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    reset_message();
+    prepare_msg(sqe, IORING_OP_SENDMSG, fd, &msg_);
+}
+
+auto NetSendSegmented::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        result_.emplace(result_ok(static_cast<std::size_t>(res)));
+
+    return true;
+}
+
+auto NetSendSegmented::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+auto NetSendSegmented::reset_message() noexcept -> void
+{
+    iov_.iov_base = const_cast<void*>(buffer_.data);
+    iov_.iov_len = buffer_.size;
+    msg_ = msghdr {};
+    if (addr_.sin_family != AF_UNSPEC) {
+        msg_.msg_name = &addr_;
+        msg_.msg_namelen = sizeof(addr_);
+    }
+    msg_.msg_iov = &iov_;
+    msg_.msg_iovlen = 1;
+    msg_.msg_control = control_;
+    msg_.msg_controllen = sizeof(control_);
+
+    auto* cmsg = CMSG_FIRSTHDR(&msg_);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(segment_size_));
+    std::memcpy(CMSG_DATA(cmsg), &segment_size_, sizeof(segment_size_));
+}
+
+NetReceiveCoalesced::NetReceiveCoalesced(BufferView buffer) noexcept
+    : buffer_ { buffer }
+{
+}
+
+auto NetReceiveCoalesced::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    reset_message();
+    auto const r = ::recvmsg(fd, &msg_, 0);
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        return false;
+
+    if (r < 0) {
+        result_.emplace(
+            result_error(std::error_code { errno, std::system_category() }));
+    }
+    else {
+        set_received(static_cast<std::size_t>(r));
+    }
+
+    return true;
+}
+
+auto NetReceiveCoalesced::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    reset_message();
+    prepare_msg(sqe, IORING_OP_RECVMSG, fd, &msg_);
+}
+
+auto NetReceiveCoalesced::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        set_received(static_cast<std::size_t>(res));
+
+    return true;
+}
+
+auto NetReceiveCoalesced::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+auto NetReceiveCoalesced::reset_message() noexcept -> void
+{
+    iov_.iov_base = buffer_.data;
+    iov_.iov_len = buffer_.size;
+    msg_ = msghdr {};
+    msg_.msg_name = &source_addr_;
+    msg_.msg_namelen = sizeof(source_addr_);
+    msg_.msg_iov = &iov_;
+    msg_.msg_iovlen = 1;
+    msg_.msg_control = control_;
+    msg_.msg_controllen = sizeof(control_);
+}
+
+auto NetReceiveCoalesced::set_received(std::size_t size) noexcept -> void
+{
+    /* The control message is only present if the datagram was
+     * coalesced...
+     */
+    std::uint16_t segment_size = 0;
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg_); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg_, cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int value;
+            std::memcpy(&value, CMSG_DATA(cmsg), sizeof(value));
+            segment_size = static_cast<std::uint16_t>(value);
+        }
+    }
+
+    auto const truncated = (msg_.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0;
+    result_.emplace(result_ok(
+        CoalescedDatagram { size, source_addr_, segment_size, truncated }));
+}
+
+ZerocopySend::ZerocopySend(ConstBufferView buffer,
+                           ZerocopyState* state) noexcept
+    : buffer_ { buffer }
+    , state_ { state }
+{
+    EXIOS_EXPECT(state_ != nullptr);
+}
+
+auto ZerocopySend::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    auto const r = ::send(
+        fd, buffer_.data, buffer_.size, MSG_ZEROCOPY | MSG_NOSIGNAL);
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        return false;
+
+    if (r < 0) {
+        result_.emplace(
+            result_error(std::error_code { errno, std::system_category() }));
+    }
+    else {
+        set_sent(static_cast<std::size_t>(r));
+    }
+
+    return true;
+}
+
+auto ZerocopySend::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    iov_.iov_base = const_cast<void*>(buffer_.data);
+    iov_.iov_len = buffer_.size;
+    msg_ = msghdr {};
+    msg_.msg_iov = &iov_;
+    msg_.msg_iovlen = 1;
+    prepare_msg(sqe, IORING_OP_SENDMSG, fd, &msg_);
+    sqe.msg_flags |= MSG_ZEROCOPY;
+}
+
+auto ZerocopySend::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+    if (is_would_block(res))
+        return false;
+
+    if (res < 0)
+        result_.emplace(result_error(to_error(res)));
+    else
+        set_sent(static_cast<std::size_t>(res));
+
+    return true;
+}
+
+auto ZerocopySend::cancel() noexcept -> void
+{
+    result_.emplace(
+        result_error(std::make_error_code(std::errc::operation_canceled)));
+}
+
+auto ZerocopySend::set_sent(std::size_t size) noexcept -> void
+{
+    /* Sends on an FD are performed one at a time, in order, so we number
+     * them in the same order as the kernel does...
+     */
+    auto const id = state_->next_id.fetch_add(1, std::memory_order_relaxed);
+    result_.emplace(result_ok(std::make_pair(size, id)));
+}
+
+ZerocopyRelease::ZerocopyRelease(ZerocopyState* state,
+                                 std::uint32_t id) noexcept
+    : state_ { state }
+    , id_ { id }
+{
+    EXIOS_EXPECT(state_ != nullptr);
+}
+
+auto ZerocopyRelease::io(int fd) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+
+    while (!released()) {
+        reset_message();
+        auto const r = ::recvmsg(fd, &msg_, MSG_ERRQUEUE);
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return false;
+
+        if (r < 0) {
+            result_.emplace(result_error(
+                std::error_code { errno, std::system_category() }));
+            return true;
+        }
+
+        record_notification();
+    }
+
+    result_.emplace(ZerocopyReleaseResult {});
+    return true;
+}
+
+auto ZerocopyRelease::prepare(int fd, io_uring_sqe& sqe) noexcept -> void
+{
+    reset_message();
+    prepare_msg(sqe, IORING_OP_RECVMSG, fd, &msg_);
+    sqe.msg_flags = MSG_ERRQUEUE;
+}
+
+auto ZerocopyRelease::complete(int res) noexcept -> bool
+{
+    EXIOS_EXPECT(!result_);
+
+    /* Another operation may have read the notification that releases
+     * this one...
+     */
+    if (!released()) {
+        if (is_would_block(res))
+            return false;
+
+        if (res < 0) {
+            result_.emplace(result_error(to_error(res)));
+            return true;
+        }
+
+        record_notification();
+        if (!released())
+            return false;
+    }
+
+    result_.emplace(ZerocopyReleaseResult {});
+    return true;
+}
+
+auto ZerocopyRelease::cancel() noexcept -> void
 {
     result_.emplace(
         result_error(std::make_error_code(std::errc::operation_canceled)));
 }
 
+auto ZerocopyRelease::released() noexcept -> bool
+{
+    return id_precedes(id_,
+                       state_->released.load(std::memory_order_acquire));
+}
+
+auto ZerocopyRelease::reset_message() noexcept -> void
+{
+    msg_ = msghdr {};
+    msg_.msg_control = control_;
+    msg_.msg_controllen = sizeof(control_);
+}
+
+auto ZerocopyRelease::record_notification() noexcept -> void
+{
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg_); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg_, cmsg)) {
+        if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+            !(cmsg->cmsg_level == SOL_IPV6 &&
+              cmsg->cmsg_type == IPV6_RECVERR))
+            continue;
+
+        sock_extended_err err;
+        std::memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+        if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY || err.ee_errno != 0)
+            continue;
+
+        /* The notification covers IDs `ee_info` to `ee_data`,
+         * inclusive...
+         */
+        auto const end = err.ee_data + 1;
+        auto current = state_->released.load(std::memory_order_relaxed);
+        while (id_precedes(current, end) &&
+               !state_->released.compare_exchange_weak(
+                   current, end, std::memory_order_acq_rel))
+            ;
+    }
+}
+
 } // namespace exios
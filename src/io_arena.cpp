@@ -0,0 +1,185 @@
+#include "exios/io_arena.hpp"
+#include "exios/contracts.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+namespace
+{
+
+constexpr std::uint64_t kOffsetMask = 0xffff'ffffull;
+constexpr std::uint64_t kLiveOne = 1ull << 32;
+constexpr std::uint64_t kLiveMask = 0x7fff'ffffull << 32;
+constexpr std::uint64_t kReleased = 1ull << 63;
+
+auto align_up(std::uint64_t offset, std::size_t alignment) noexcept
+    -> std::uint64_t
+{
+    return (offset + alignment - 1) & ~std::uint64_t { alignment - 1 };
+}
+
+} // namespace
+
+namespace exios
+{
+
+auto IoArena::create(std::size_t capacity, std::pmr::memory_resource* upstream)
+    -> IoArena*
+{
+    EXIOS_EXPECT(capacity <= std::numeric_limits<std::uint32_t>::max());
+    EXIOS_EXPECT(upstream != nullptr);
+
+    /* The block lives directly after the arena itself...
+     */
+    auto* mem = ::operator new(sizeof(IoArena) + capacity,
+                               std::align_val_t { alignof(IoArena) });
+
+    return ::new (mem) IoArena { capacity, upstream };
+}
+
+/* Each half starts suitably aligned for anything...
+ */
+IoArena::IoArena(std::size_t capacity,
+                 std::pmr::memory_resource* upstream) noexcept
+    : upstream_ { upstream }
+    , capacity_ { capacity }
+    , half_capacity_ { (capacity / kHalves) &
+                       ~std::size_t { alignof(IoArena) - 1 } }
+{
+}
+
+auto IoArena::release() noexcept -> void
+{
+    auto const previous = state_.fetch_or(kReleased, std::memory_order_acq_rel);
+    if ((previous & kLiveMask) == 0)
+        destroy();
+}
+
+auto IoArena::capacity() const noexcept -> std::size_t { return capacity_; }
+
+auto IoArena::upstream() const noexcept -> std::pmr::memory_resource*
+{
+    return upstream_;
+}
+
+auto IoArena::do_allocate(std::size_t size, std::size_t alignment) -> void*
+{
+    /* Every allocation counts as live, wherever it comes from, so the
+     * arena isn't destroyed while it can still be returned to it...
+     */
+    state_.fetch_add(kLiveOne, std::memory_order_relaxed);
+
+    if (alignment <= alignof(IoArena)) {
+        auto const current = current_.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < kHalves; ++i) {
+            auto const half = (current + i) % kHalves;
+            if (auto* ptr = allocate_from(half, size, alignment)) {
+                if (half != current)
+                    current_.store(half, std::memory_order_relaxed);
+
+                return ptr;
+            }
+        }
+    }
+
+    try {
+        return upstream_->allocate(size, alignment);
+    }
+    catch (...) {
+        release_allocation();
+        throw;
+    }
+}
+
+auto IoArena::do_deallocate(void* ptr,
+                            std::size_t size,
+                            std::size_t alignment) -> void
+{
+    if (owns(ptr)) {
+        auto const offset =
+            static_cast<std::size_t>(static_cast<std::byte*>(ptr) - storage());
+        release_from(offset / half_capacity_);
+    }
+    else {
+        upstream_->deallocate(ptr, size, alignment);
+    }
+
+    release_allocation();
+}
+
+auto IoArena::do_is_equal(std::pmr::memory_resource const& other) const noexcept
+    -> bool
+{
+    return this == &other;
+}
+
+auto IoArena::storage() noexcept -> std::byte*
+{
+    return reinterpret_cast<std::byte*>(this + 1);
+}
+
+auto IoArena::owns(void const* ptr) noexcept -> bool
+{
+    auto const* p = static_cast<std::byte const*>(ptr);
+    return p >= storage() && p < storage() + half_capacity_ * kHalves;
+}
+
+auto IoArena::allocate_from(std::size_t half,
+                            std::size_t size,
+                            std::size_t alignment) noexcept -> void*
+{
+    auto& word = halves_[half];
+    auto state = word.load(std::memory_order_relaxed);
+
+    for (;;) {
+        /* Even an empty request needs an address within the half, so
+         * that it's returned to the right one...
+         */
+        auto const offset = align_up(state & kOffsetMask, alignment);
+        if (offset >= half_capacity_ || offset + size > half_capacity_)
+            return nullptr;
+
+        auto const next = (state & ~kOffsetMask) + kLiveOne + offset + size;
+        if (word.compare_exchange_weak(
+                state, next, std::memory_order_acq_rel))
+            return storage() + half * half_capacity_ + offset;
+    }
+}
+
+auto IoArena::release_from(std::size_t half) noexcept -> void
+{
+    auto& word = halves_[half];
+    auto state = word.load(std::memory_order_relaxed);
+    std::uint64_t next;
+
+    /* Returning the last live allocation of a half is its reset point;
+     * The whole half is free to be handed out again...
+     */
+    do {
+        next = state - kLiveOne;
+        if ((next & kLiveMask) == 0)
+            next = 0;
+    }
+    while (
+        !word.compare_exchange_weak(state, next, std::memory_order_acq_rel));
+}
+
+auto IoArena::release_allocation() noexcept -> void
+{
+    auto const previous =
+        state_.fetch_sub(kLiveOne, std::memory_order_acq_rel);
+
+    if (previous - kLiveOne == kReleased)
+        destroy();
+}
+
+auto IoArena::destroy() noexcept -> void
+{
+    this->~IoArena();
+    ::operator delete(static_cast<void*>(this),
+                      std::align_val_t { alignof(IoArena) });
+}
+
+} // namespace exios
@@ -1,26 +1,139 @@
 #include "exios/io_object.hpp"
+#include "exios/contracts.hpp"
 #include "exios/file_descriptor.hpp"
 #include "exios/io_scheduler.hpp"
+#include <mutex>
+#include <utility>
 
 namespace exios
 {
 
+namespace detail
+{
+
+auto SpliceList::add(SpliceLink::Hook* hook) noexcept -> void
+{
+    std::lock_guard lock { mutex_ };
+    hooks_.push_back(hook);
+}
+
+auto SpliceList::remove(SpliceLink::Hook* hook) noexcept -> void
+{
+    std::lock_guard lock { mutex_ };
+    static_cast<void>(hooks_.erase(hook));
+}
+
+auto SpliceList::empty() const noexcept -> bool
+{
+    std::lock_guard lock { mutex_ };
+    return hooks_.empty();
+}
+
+auto SpliceList::cancel_all() noexcept -> bool
+{
+    std::lock_guard lock { mutex_ };
+    for (auto& hook : hooks_)
+        hook.link->cancel();
+
+    return !hooks_.empty();
+}
+
+} // namespace detail
+
 IoObject::IoObject(Context const& ctx, FileDescriptor&& fd) noexcept
     : ctx_ { ctx }
     , fd_ { std::move(fd) }
 {
 }
 
+IoObject::IoObject(IoObject&& other) noexcept
+    : ctx_ { other.ctx_ }
+    , fd_ { std::move(other.fd_) }
+    , persistent_ { std::exchange(other.persistent_, false) }
+    , arena_ { std::exchange(other.arena_, nullptr) }
+{
+    /* A splice refers to the objects it was started on...
+     */
+    EXIOS_EXPECT(other.splices_.empty());
+}
+
+IoObject::~IoObject()
+{
+    release_persistent_registration();
+    release_arena();
+}
+
+auto IoObject::operator=(IoObject&& other) noexcept -> IoObject&
+{
+    if (this == &other)
+        return *this;
+
+    EXIOS_EXPECT(splices_.empty());
+    EXIOS_EXPECT(other.splices_.empty());
+    release_persistent_registration();
+    release_arena();
+    ctx_ = other.ctx_;
+    fd_ = std::move(other.fd_);
+    persistent_ = std::exchange(other.persistent_, false);
+    arena_ = std::exchange(other.arena_, nullptr);
+    return *this;
+}
+
+auto IoObject::enable_persistent_registration() -> void
+{
+    ctx_.io_scheduler().register_persistent(fd_.value());
+    persistent_ = true;
+}
+
+auto IoObject::release_persistent_registration() noexcept -> void
+{
+    if (persistent_)
+        ctx_.io_scheduler().release_persistent(fd_.value());
+    persistent_ = false;
+}
+
+auto IoObject::enable_arena(std::size_t capacity) -> void
+{
+    auto* arena = IoArena::create(capacity, get_allocator().resource());
+    release_arena();
+    arena_ = arena;
+}
+
+auto IoObject::release_arena() noexcept -> void
+{
+    if (arena_)
+        std::exchange(arena_, nullptr)->release();
+}
+
+auto IoObject::get_allocator() const noexcept
+    -> std::pmr::polymorphic_allocator<std::byte>
+{
+    if (arena_)
+        return std::pmr::polymorphic_allocator<std::byte> { arena_ };
+
+    return ctx_.get_allocator();
+}
+
 auto IoObject::schedule_io(AsyncIoOperation* op) noexcept -> void
 {
     ctx_.io_scheduler().schedule(op);
 }
 
+auto IoObject::schedule_speculative_io(AsyncIoOperation* op) noexcept -> void
+{
+    ctx_.io_scheduler().schedule_speculative(op);
+}
+
 auto schedule_io(Context ctx, AsyncIoOperation* op) noexcept -> void
 {
     ctx.io_scheduler().schedule(op);
 }
 
+auto cancel_io(Context ctx, int fd) noexcept -> void
+{
+    ctx.io_scheduler().cancel(fd);
+}
+
 auto IoObject::get_context() const noexcept -> Context const&
 {
     return ctx_;
@@ -28,12 +141,19 @@ auto IoObject::get_context() const noexcept -> Context const&
 
 auto IoObject::close() noexcept -> void
 {
-    ::close(fd_.value());
+    release_persistent_registration();
+    release_arena();
     fd_ = FileDescriptor {};
 }
 
 auto IoObject::cancel() noexcept -> void
 {
+    /* A splice cancels the operations on both of its objects, which
+     * includes this one...
+     */
+    if (splices_.cancel_all())
+        return;
+
     ctx_.io_scheduler().cancel(fd_.value());
 }
 
@@ -9,8 +9,13 @@
 #include <atomic>
 #include <cerrno>
 #include <cstddef>
+#include <cstdlib>
 #include <errno.h>
+#include <memory>
+#include <memory_resource>
+#include <new>
 #include <span>
+#include <string_view>
 #include <sys/epoll.h>
 #include <unistd.h>
 #include <vector>
@@ -19,8 +24,6 @@ namespace
 {
 constexpr std::size_t kMaxEventsPerPoll = 1024;
 
-std::atomic_uint64_t threads_waiting = 0;
-
 auto decrement_count(std::atomic_size_t& counter, std::size_t val) -> void
 {
     auto const prev = counter.fetch_sub(val);
@@ -33,133 +36,77 @@ auto event_buffer() -> std::span<epoll_event>
     return { buffer.data(), buffer.size() };
 }
 
-[[nodiscard]] auto process_notifications(
-    int efd,
-    std::span<epoll_event> events,
-    exios::PollWakeEvent& wake_event,
-    exios::IntrusiveList<exios::AsyncIoOperation>::iterator /*first*/,
-    exios::IntrusiveList<exios::AsyncIoOperation>::iterator last,
-    exios::IntrusiveList<exios::AsyncIoOperation>& list) noexcept -> std::size_t
+/* Performs I/O on the pending operations at the front of `queue`, posting
+ * each completed operation to its context. We stop at the first operation
+ * that would block; Operations for the same FD and direction are serviced in
+ * the order they were scheduled, so anything queued behind it would block
+ * too...
+ */
+[[nodiscard]] auto perform_pending_io(
+    exios::IntrusiveList<exios::AsyncIoOperation>& queue) noexcept
+    -> std::size_t
 {
-    std::size_t total_processed = 0;
-
-    for (auto& event : events) {
-
-        auto fd = event.data.fd;
-        if (fd == wake_event.get_fd()) {
-            wake_event.reset();
-            continue;
-        }
-
-        auto first = std::lower_bound(
-            list.begin(), last, fd, [](auto const& item, auto const& val) {
-                return item.get_fd() < val;
-            });
-
-        auto next = first;
-
-        std::size_t items_for_this_fd = 0;
-        std::size_t items_processed_for_this_fd = 0;
-        decltype(event.events) events_to_reregister = 0;
-
-        while (next != last && next->get_fd() == fd) {
-
-            items_for_this_fd++;
-            auto& item = *next++;
-
-            auto const new_interest =
-                (item.is_read_operation() ? EPOLLIN : EPOLLOUT);
-            exios::ScopeGuard reset_event { [&] {
-                events_to_reregister |= new_interest;
-            } };
-
-            if (item.cancelled()) {
-                continue;
-            }
-
-            /* We only want to perform IO on operations
-             * matching the correct poll events received...
-             */
-            if (((event.events & EPOLLIN) != 0) != (item.is_read_operation())) {
-                continue;
-            }
-
-            /* A return value of `false` means the I/O operation
-             * resulted in EAGAIN / EWOULDBLOCK, and we have to leave the
-             * operation in the list. This may sound unecessary, but
-             * we're allowing multiple operations to be queued for the
-             * same FD, so only one IO operation per FD is guaranteed
-             * to succeed without blocking...
-             */
-            if (!item.perform_io()) {
-                continue;
-            }
-
-            reset_event.deactivate();
+    std::size_t num_processed = 0;
 
-            /* WARNING: The order of these operations is crucial; We must
-             * erase the item from `list` _BEFORE_ posting to the
-             * context's completion queue, otherwise the call to `.erase()`
-             * is operating on the completion queue's list instead of our
-             * list - UB, basically!...
-             */
-            next = list.erase(&item);
-            item.get_context().post(&item);
+    while (!queue.empty()) {
+        auto& item = queue.front();
 
-            items_processed_for_this_fd++;
-        }
+        if (!item.perform_io())
+            break;
 
-        /* If we've processed all the pending operations for the
-         * given FD then we can de-register it from epoll...
+        /* WARNING: The order of these operations is crucial; We must
+         * remove the item from `queue` _BEFORE_ posting to the
+         * context's completion queue, otherwise the item's links
+         * belong to the completion queue instead of our queue...
          */
-        if (items_for_this_fd == items_processed_for_this_fd) {
-            auto const error = ::epoll_ctl(efd, EPOLL_CTL_DEL, fd, &event);
-            EXIOS_EXPECT(!error || errno == ENOENT);
-        }
-        else {
-            /* ...Otherwise, we must reset the events we want to listen for.
-             * This is especially important for eventfds because if we don't
-             * then we could still get woken for writes when there are only
-             * reads waiting, potentially causing a busy loop that makes no
-             * progress (and consumes all the CPU)...
-             */
-            event.events = events_to_reregister;
-            EXIOS_EXPECT(::epoll_ctl(efd, EPOLL_CTL_MOD, fd, &event) == 0);
-        }
-
-        total_processed += items_processed_for_this_fd;
+        queue.pop_front();
+        item.get_context().post(&item);
+        ++num_processed;
     }
 
-    return total_processed;
+    return num_processed;
 }
 
 auto process_cancellations(
-    exios::IntrusiveList<exios::AsyncIoOperation>::iterator first,
-    exios::IntrusiveList<exios::AsyncIoOperation>::iterator last,
-    exios::IntrusiveList<exios::AsyncIoOperation>& list,
-    std::size_t& count) noexcept
-    -> exios::IntrusiveList<exios::AsyncIoOperation>::iterator
+    exios::IntrusiveList<exios::AsyncIoOperation>& list) noexcept -> std::size_t
 {
-    auto next = first;
-    while (next != last) {
-        auto& item = *next;
-        next = list.erase(next);
+    std::size_t count = 0;
+    drain_list(list, [&](auto&& item) noexcept {
         ++count;
         item.get_context().post(&item);
-    }
+    });
 
-    return next;
+    return count;
 }
 
 } // namespace
 
 namespace exios
 {
-IoScheduler::IoScheduler(ContextThread& ctx)
+auto default_io_backend() noexcept -> IoBackend
+{
+    auto const* value = std::getenv("EXIOS_IO_BACKEND");
+    if (value != nullptr && std::string_view { value } == "io_uring" &&
+        IoUring::is_supported()) {
+        return IoBackend::io_uring;
+    }
+
+    return IoBackend::epoll;
+}
+
+IoScheduler::IoScheduler(ContextThread& ctx,
+                         IoBackend backend,
+                         std::pmr::memory_resource* table_resource)
     : ctx_ { ctx }
-    , epoll_fd_ { epoll_create1(EPOLL_CLOEXEC) }
-    , begin_cancelled_ { operations_.end() }
+    , epoll_fd_ { -1 }
+    , slots_ { table_resource }
 {
+    if (backend == IoBackend::io_uring) {
+        uring_ = std::make_unique<IoUring>(wake_event_, table_resource);
+        return;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
     if (epoll_fd_ < 0)
         throw std::system_error { errno, std::system_category() };
 
@@ -179,128 +126,386 @@ IoScheduler::IoScheduler(ContextThread& ctx)
 
 IoScheduler::~IoScheduler()
 {
-    ::close(epoll_fd_);
-    drain_list(operations_, [](auto&& item) { discard(std::move(item)); });
+    if (epoll_fd_ >= 0)
+        ::close(epoll_fd_);
+
+    auto const discard_item = [](auto&& item) { discard(std::move(item)); };
+    for (auto& slot : slots_) {
+        drain_list(slot.reads, discard_item);
+        drain_list(slot.writes, discard_item);
+        drain_list(slot.errors, discard_item);
+    }
+    drain_list(cancelled_, discard_item);
 }
 
 auto IoScheduler::wake() noexcept -> void
 {
-    wake_event_.trigger(threads_waiting);
+    /* Only threads that may be blocked in `poll_once()` need waking, and
+     * a single signal wakes all of them; Anyone else will see the new
+     * state before they next block...
+     */
+    if (waiters_ == 0 || wake_pending_.exchange(true))
+        return;
+
+    wake_event_.trigger(1);
 }
 
-auto IoScheduler::schedule(AsyncIoOperation* op) noexcept -> void
+auto IoScheduler::slot_for(int fd) -> FdSlot&
 {
-    /* Scheduled operations are stored in a flat hash-table; They
-     * are stored in order of their FD, with ops for the same FD
-     * stored consecutively. This makes lookup operations a binary
-     * search + N AsyncIoOperation per FD.
+    EXIOS_EXPECT(fd >= 0);
+    auto const index = static_cast<std::size_t>(fd);
+    if (index >= slots_.size())
+        slots_.resize(std::max(index + 1, slots_.size() * 2));
+
+    return slots_[index];
+}
+
+auto IoScheduler::queue_for(FdSlot& slot, AsyncIoOperation& op) noexcept
+    -> IntrusiveList<AsyncIoOperation>&
+{
+    if (op.is_error_queue_operation())
+        return slot.errors;
+
+    return op.is_read_operation() ? slot.reads : slot.writes;
+}
+
+auto IoScheduler::update_interest(int fd, FdSlot& slot) noexcept -> void
+{
+    /* Persistent registrations are left as they are until they're
+     * released...
      */
+    if (slot.persistent)
+        return;
 
-    std::lock_guard lock { data_mutex_ };
+    std::uint32_t interest = 0;
+    if (!slot.reads.empty())
+        interest |= EPOLLIN;
+    if (!slot.writes.empty())
+        interest |= EPOLLOUT;
 
-    auto first = operations_.begin();
-    auto last = begin_cancelled_;
+    /* epoll always reports `EPOLLERR`; Asking for it just keeps the FD
+     * registered while there's nothing else to wait for...
+     */
+    if (!slot.errors.empty())
+        interest |= EPOLLERR;
+
+    if (interest == slot.interest)
+        return;
 
-    auto const fd = op->get_fd();
     epoll_event ev {};
     ev.data.fd = fd;
-    ev.events = (op->is_read_operation() ? EPOLLIN : EPOLLOUT);
-
-    auto insert_pos = last;
+    ev.events = interest;
 
-    if (first != last && fd <= (*first).get_fd()) {
-        insert_pos = first;
+    if (interest == 0) {
+        auto const error = ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &ev);
+        EXIOS_EXPECT(!error || errno == ENOENT || errno == EBADF);
     }
-    else if (first != last && fd >= (*std::prev(last)).get_fd()) {
-        insert_pos = last;
+    else if (slot.interest == 0) {
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            EXIOS_EXPECT(errno == EEXIST &&
+                         ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) == 0);
+        }
+    }
+    else if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) < 0) {
+        /* The FD may have been closed, and the number reused, since we
+         * last registered it; The kernel will have dropped the old
+         * registration in that case...
+         */
+        EXIOS_EXPECT(errno == ENOENT &&
+                     ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == 0);
     }
-    else {
-        insert_pos = std::lower_bound(
-            first, last, fd, [](auto const& a, auto const val) {
-                return a.get_fd() < val;
-            });
+
+    slot.interest = interest;
+}
+
+auto IoScheduler::perform_ready_io(FdSlot& slot) noexcept -> std::size_t
+{
+    std::size_t num_processed = 0;
+
+    /* If an operation would block then we no longer know the FD to be
+     * ready; The remaining operations stay parked until epoll notifies us
+     * of the next edge...
+     */
+    if ((slot.readiness & EPOLLIN) != 0) {
+        num_processed += perform_pending_io(slot.reads);
+        if (!slot.reads.empty())
+            slot.readiness &= ~std::uint32_t { EPOLLIN };
     }
 
-    while (insert_pos != last && insert_pos->get_fd() == fd) {
-        ev.events |= (insert_pos->is_read_operation() ? EPOLLIN : EPOLLOUT);
-        ++insert_pos;
+    if ((slot.readiness & EPOLLOUT) != 0) {
+        num_processed += perform_pending_io(slot.writes);
+        if (!slot.writes.empty())
+            slot.readiness &= ~std::uint32_t { EPOLLOUT };
     }
 
+    return num_processed;
+}
+
+auto IoScheduler::register_persistent(int fd) -> void
+{
+    if (uring_)
+        return;
+
+    std::lock_guard lock { data_mutex_ };
+
+    auto& slot = slot_for(fd);
+    if (slot.persistent)
+        return;
+
+    epoll_event ev {};
+    ev.data.fd = fd;
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+
     if (auto const r = ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev); r < 0) {
         if (errno != EEXIST ||
             ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) < 0) {
-            // cppcheck-suppress [incorrectStringBooleanError]
-            EXIOS_EXPECT(false && "Failed to register epoll event");
+            throw std::system_error { errno, std::system_category() };
         }
     }
 
-    static_cast<void>(operations_.insert(op, insert_pos));
-    poll_queue_length_ += 1;
-    ctx_.notify();
+    /* We don't know how ready the FD is yet. Arming the registration
+     * causes epoll to report the FD's current state, so we'll find out
+     * on the next poll...
+     */
+    slot.persistent = true;
+    slot.interest = ev.events;
+    slot.readiness = 0;
 }
 
-auto IoScheduler::cancel(int fd) noexcept -> void
+auto IoScheduler::release_persistent(int fd) noexcept -> void
+{
+    if (uring_)
+        return;
+
+    std::lock_guard lock { data_mutex_ };
+
+    if (fd < 0 || static_cast<std::size_t>(fd) >= slots_.size())
+        return;
+
+    auto& slot = slots_[static_cast<std::size_t>(fd)];
+    if (!slot.persistent)
+        return;
+
+    auto const error = ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    EXIOS_EXPECT(!error || errno == ENOENT || errno == EBADF);
+
+    slot.persistent = false;
+    slot.interest = 0;
+    slot.readiness = 0;
+
+    /* Any operations that are still pending go back to being
+     * registered on demand...
+     */
+    update_interest(fd, slot);
+}
+
+auto IoScheduler::schedule(AsyncIoOperation* op) noexcept -> void
+{
+    schedule(op, false);
+}
+
+auto IoScheduler::schedule_speculative(AsyncIoOperation* op) noexcept -> void
 {
+    schedule(op, true);
+}
+
+auto IoScheduler::schedule(AsyncIoOperation* op, bool speculative) noexcept
+    -> void
+{
+    if (uring_) {
+        uring_->schedule(op, speculative);
+        ctx_.notify();
+        return;
+    }
+
+    /* Scheduled operations are stored in a table indexed by their FD, so
+     * scheduling, cancelling and dispatching notifications are constant
+     * time regardless of how many operations are pending...
+     */
+
     std::lock_guard lock { data_mutex_ };
 
-    auto first = operations_.begin();
-    auto last = begin_cancelled_;
+    auto const fd = op->get_fd();
+    FdSlot* slot_ptr = nullptr;
+
+    /* The table grows to fit the largest FD we've seen. If it can't, the
+     * operation fails, rather than the exception escaping...
+     */
+    try {
+        slot_ptr = &slot_for(fd);
+    }
+    catch (std::bad_alloc const&) {
+        op->fail(ENOMEM);
+        op->get_context().post(op);
+        return;
+    }
+
+    auto& slot = *slot_ptr;
+    auto& queue = queue_for(slot, *op);
 
-    /* Find the range where all items equal `fd`...
+    /* Persistently registered FDs already perform I/O straight away when
+     * they're known to be ready, so there's nothing to gain from
+     * speculating on them. Error queue operations are the exception;
+     * Their readiness isn't cached, and the notification they're waiting
+     * for may already have been queued (and its edge consumed), so they're
+     * always attempted first...
      */
-    auto first_pos =
-        std::lower_bound(first, last, fd, [](auto const& a, auto const val) {
-            return a.get_fd() < val;
-        });
+    auto const attempt =
+        op->is_error_queue_operation() || (speculative && !slot.persistent);
+
+    /* NOTE:
+     * The I/O is performed with `data_mutex_` held, here and whenever the
+     * FD is found to be ready, so it mustn't block. Operations only make
+     * non-blocking calls; The exception is `sendfile()`, which may wait
+     * on a disk read of its file (See ::exios::IoTransferFile)...
+     */
+    if (attempt && queue.empty() && op->perform_io()) {
+        op->get_context().post(op);
+        return;
+    }
+
+    queue.push_back(op);
+
+    poll_queue_length_ += 1;
+
+    if (slot.persistent)
+        decrement_count(poll_queue_length_, perform_ready_io(slot));
+    else
+        update_interest(fd, slot);
+
+    ctx_.notify();
+}
+
+auto IoScheduler::cancel(int fd) noexcept -> void
+{
+    if (uring_) {
+        uring_->cancel(fd);
+        wake();
+        ctx_.notify();
+        return;
+    }
 
-    auto last_pos = std::find_if(
-        first_pos, last, [&](auto const& item) { return item.get_fd() != fd; });
+    std::lock_guard lock { data_mutex_ };
 
     /* We didn't find any FDs to cancel...
      */
-    if (first_pos == last_pos)
+    if (fd < 0 || static_cast<std::size_t>(fd) >= slots_.size())
+        return;
+
+    auto& slot = slots_[static_cast<std::size_t>(fd)];
+    if (slot.reads.empty() && slot.writes.empty() && slot.errors.empty())
         return;
 
     /* Cancel the operations...
      */
-    std::for_each(first_pos, last_pos, [](auto& item) { item.cancel(); });
-
-    /* Move the cancelled FDs to the back of the list. We won't
-     * remove them in anticipation of `cancel` being called from
-     * a different thread; The FD may get notified while we're
-     * cancelling it, so it needs to remain at least somewhere
-     * in the list until we can safely remove it...
+    std::for_each(slot.reads.begin(), slot.reads.end(), [](auto& item) {
+        item.cancel();
+    });
+    std::for_each(slot.writes.begin(), slot.writes.end(), [](auto& item) {
+        item.cancel();
+    });
+    std::for_each(slot.errors.begin(), slot.errors.end(), [](auto& item) {
+        item.cancel();
+    });
+
+    /* Move the cancelled operations to the cancelled list. We won't
+     * post them here in anticipation of `cancel` being called from
+     * a different thread; They're completed on the next call to
+     * `poll_once`...
      */
-    begin_cancelled_ =
-        operations_.splice(begin_cancelled_, first_pos, last_pos);
+    static_cast<void>(cancelled_.splice(cancelled_.end(), slot.reads));
+    static_cast<void>(cancelled_.splice(cancelled_.end(), slot.writes));
+    static_cast<void>(cancelled_.splice(cancelled_.end(), slot.errors));
 
     /* De-register the FD...
      */
-    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
-    wake_event_.trigger(threads_waiting);
+    update_interest(fd, slot);
+    wake();
     ctx_.notify();
 }
 
 auto IoScheduler::empty() const noexcept -> bool
 {
+    if (uring_)
+        return uring_->empty();
+
     return poll_queue_length_ == 0;
 }
 
+auto IoScheduler::process_notification(int fd, std::uint32_t events) noexcept
+    -> std::size_t
+{
+    if (fd < 0 || static_cast<std::size_t>(fd) >= slots_.size())
+        return 0;
+
+    auto& slot = slots_[static_cast<std::size_t>(fd)];
+
+    std::size_t num_processed = 0;
+    if ((events & (EPOLLERR | EPOLLHUP)) != 0)
+        num_processed += perform_pending_io(slot.errors);
+
+    if (slot.persistent) {
+        if ((events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0)
+            slot.readiness |= EPOLLIN;
+        if ((events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0)
+            slot.readiness |= EPOLLOUT;
+
+        return num_processed + perform_ready_io(slot);
+    }
+
+    /* Errors and hang-ups are reported to operations in both directions;
+     * The failed I/O call will give them the appropriate error...
+     */
+    if ((events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0)
+        num_processed += perform_pending_io(slot.reads);
+
+    if ((events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0)
+        num_processed += perform_pending_io(slot.writes);
+
+    /* Reset the events we want to listen for. This is especially
+     * important for eventfds because if we don't then we could still get
+     * woken for writes when there are only reads waiting, potentially
+     * causing a busy loop that makes no progress (and consumes all the
+     * CPU). If we've processed all the pending operations for the FD
+     * then this de-registers it from epoll...
+     */
+    update_interest(fd, slot);
+
+    return num_processed;
+}
+
 auto IoScheduler::poll_once(bool block) -> std::size_t
 {
+    /* Once we're counted as a waiter, anything that would need to wake
+     * us will signal `wake_event_`. Work that arrived before then won't,
+     * so we check for it before blocking...
+     */
+    bool const counted = block;
+    if (counted) {
+        waiters_ += 1;
+        block = !ctx_.ready_to_run();
+    }
+
+    EXIOS_SCOPE_GUARD([&] {
+        if (counted) {
+            wake_pending_ = false;
+            waiters_ -= 1;
+        }
+    });
+
+    if (uring_)
+        return uring_->poll_once(block);
+
     std::size_t num_cancelled = 0;
     {
         std::lock_guard lock { data_mutex_ };
-        begin_cancelled_ = process_cancellations(
-            begin_cancelled_, operations_.end(), operations_, num_cancelled);
+        num_cancelled = process_cancellations(cancelled_);
 
-        EXIOS_EXPECT(begin_cancelled_ == operations_.end());
+        EXIOS_EXPECT(cancelled_.empty());
         decrement_count(poll_queue_length_, num_cancelled);
 
-        if (operations_.begin() == begin_cancelled_) {
-            EXIOS_EXPECT(poll_queue_length_ == 0);
+        if (poll_queue_length_ == 0)
             return 0;
-        }
     }
 
     auto buffer = event_buffer();
@@ -318,10 +523,8 @@ auto IoScheduler::poll_once(bool block) -> std::size_t
     std::size_t num_processed = 0;
 
     do {
-        threads_waiting += 1;
         auto const r = ::epoll_pwait(
             epoll_fd_, buffer.data(), buffer.size(), poll_timeout, nullptr);
-        threads_waiting -= 1;
 
         /* If we have to poll again, make sure we don't block...
          */
@@ -337,12 +540,15 @@ auto IoScheduler::poll_once(bool block) -> std::size_t
 
         {
             std::lock_guard lock { data_mutex_ };
-            auto const num = process_notifications(epoll_fd_,
-                                                   events_notified,
-                                                   wake_event_,
-                                                   operations_.begin(),
-                                                   begin_cancelled_,
-                                                   operations_);
+            std::size_t num = 0;
+            for (auto const& event : events_notified) {
+                if (event.data.fd == wake_event_.get_fd()) {
+                    wake_event_.reset();
+                    continue;
+                }
+
+                num += process_notification(event.data.fd, event.events);
+            }
 
             decrement_count(poll_queue_length_, num);
 
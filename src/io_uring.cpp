@@ -0,0 +1,582 @@
+#include "exios/io_uring.hpp"
+#include "exios/async_io_operation.hpp"
+#include "exios/contracts.hpp"
+#include "exios/intrusive_list.hpp"
+#include "exios/poll_wake_event.hpp"
+#include "exios/scope_guard.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <errno.h>
+#include <iterator>
+#include <linux/io_uring.h>
+#include <memory_resource>
+#include <new>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace
+{
+constexpr std::uint32_t kRingEntries = 1024;
+
+/* The low bits of a submission's `user_data` say what the submission is
+ * for; The remaining bits hold the address of the operation, if there is
+ * one...
+ */
+constexpr std::uint64_t kWakeTag = 0;
+constexpr std::uint64_t kOperationTag = 1;
+constexpr std::uint64_t kPollTag = 2;
+constexpr std::uint64_t kCancelTag = 3;
+constexpr std::uint64_t kTagMask = 3;
+
+static_assert(alignof(exios::AsyncIoOperation) > kTagMask);
+
+/* Incremented in the child process after a fork. A forked child shares
+ * its parent's rings, so it must leave them alone...
+ */
+std::atomic_uint64_t fork_generation = 0;
+
+auto on_fork_child() noexcept -> void { fork_generation += 1; }
+
+auto encode(exios::AsyncIoOperation* op, std::uint64_t tag) noexcept
+    -> std::uint64_t
+{
+    return reinterpret_cast<std::uintptr_t>(op) | tag;
+}
+
+auto decode(std::uint64_t user_data) noexcept -> exios::AsyncIoOperation&
+{
+    return *reinterpret_cast<exios::AsyncIoOperation*>(user_data & ~kTagMask);
+}
+
+auto setup(std::uint32_t entries, io_uring_params& params) noexcept -> int
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+auto enter(int fd,
+           std::uint32_t to_submit,
+           std::uint32_t min_complete,
+           std::uint32_t flags) noexcept -> int
+{
+    return static_cast<int>(::syscall(
+        __NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+auto ring_field(void* ring, std::uint32_t offset) noexcept -> std::uint32_t*
+{
+    return reinterpret_cast<std::uint32_t*>(static_cast<char*>(ring) + offset);
+}
+
+auto map_ring(int fd, std::size_t size, off_t offset) -> void*
+{
+    auto* ptr = ::mmap(nullptr,
+                       size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       fd,
+                       offset);
+    if (ptr == MAP_FAILED)
+        throw std::system_error { errno, std::system_category() };
+
+    return ptr;
+}
+
+auto decrement_count(std::atomic_size_t& counter, std::size_t val) -> void
+{
+    auto const prev = counter.fetch_sub(val);
+    EXIOS_EXPECT(val == 0 || prev >= val);
+}
+
+auto process_cancellations(
+    exios::IntrusiveList<exios::AsyncIoOperation>& list) noexcept -> std::size_t
+{
+    std::size_t count = 0;
+    drain_list(list, [&](auto&& item) noexcept {
+        ++count;
+        item.get_context().post(&item);
+    });
+
+    return count;
+}
+
+} // namespace
+
+namespace exios
+{
+IoUring::IoUring(PollWakeEvent& wake_event,
+                 std::pmr::memory_resource* table_resource)
+    : wake_event_ { wake_event }
+    , slots_ { table_resource }
+{
+    [[maybe_unused]] static auto const fork_handler_registered =
+        ::pthread_atfork(nullptr, nullptr, on_fork_child);
+
+    generation_ = fork_generation;
+
+    io_uring_params params {};
+    ring_fd_ = setup(kRingEntries, params);
+    if (ring_fd_ < 0)
+        throw std::system_error { errno, std::system_category() };
+
+    EXIOS_SCOPE_GUARD([this] {
+        if (sqes_ == nullptr)
+            unmap();
+    });
+
+    sq_ring_size_ =
+        params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+    cq_ring_size_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    /* Newer kernels let us map both rings with a single call...
+     */
+    bool const single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap)
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+    sq_ring_ = map_ring(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap
+                   ? sq_ring_
+                   : map_ring(ring_fd_, cq_ring_size_, IORING_OFF_CQ_RING);
+
+    sq_head_ = ring_field(sq_ring_, params.sq_off.head);
+    sq_tail_ = ring_field(sq_ring_, params.sq_off.tail);
+    sq_array_ = ring_field(sq_ring_, params.sq_off.array);
+    sq_mask_ = *ring_field(sq_ring_, params.sq_off.ring_mask);
+    sq_entries_ = *ring_field(sq_ring_, params.sq_off.ring_entries);
+
+    cq_head_ = ring_field(cq_ring_, params.cq_off.head);
+    cq_tail_ = ring_field(cq_ring_, params.cq_off.tail);
+    cq_mask_ = *ring_field(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(cq_ring_) +
+                                            params.cq_off.cqes);
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(
+        map_ring(ring_fd_, sqes_size_, IORING_OFF_SQES));
+
+    std::lock_guard lock { data_mutex_ };
+    arm_wake();
+}
+
+IoUring::~IoUring()
+{
+    auto const discard_item = [](auto&& item) { discard(std::move(item)); };
+
+    if (!owned()) {
+        for (auto& slot : slots_) {
+            drain_list(slot.reads.queue, discard_item);
+            drain_list(slot.writes.queue, discard_item);
+            drain_list(slot.errors.queue, discard_item);
+        }
+        drain_list(cancelled_, discard_item);
+        ::close(ring_fd_);
+        return;
+    }
+
+    {
+        std::lock_guard lock { data_mutex_ };
+        stopping_ = true;
+
+        /* The kernel may still write to the operations that are in
+         * flight, so we must wait for all of them to complete before we
+         * can discard them...
+         */
+        submit_cancel(encode(nullptr, kWakeTag));
+        for (auto& slot : slots_) {
+            for (auto* direction :
+                 { &slot.reads, &slot.writes, &slot.errors }) {
+                if (direction->submission == Submission::none)
+                    continue;
+
+                auto const tag = direction->submission == Submission::operation
+                                     ? kOperationTag
+                                     : kPollTag;
+                submit_cancel(encode(&direction->queue.front(), tag));
+            }
+        }
+
+        while (in_flight_ > 0) {
+            auto const r = enter(
+                ring_fd_, unsubmitted(), 1, IORING_ENTER_GETEVENTS);
+            if (r < 0 && errno != EINTR)
+                break;
+
+            static_cast<void>(reap());
+        }
+    }
+
+    for (auto& slot : slots_) {
+        drain_list(slot.reads.queue, discard_item);
+        drain_list(slot.writes.queue, discard_item);
+        drain_list(slot.errors.queue, discard_item);
+    }
+    drain_list(cancelled_, discard_item);
+
+    unmap();
+}
+
+auto IoUring::is_supported() noexcept -> bool
+{
+    static bool const supported = [] {
+        io_uring_params params {};
+        auto const fd = setup(1, params);
+        if (fd < 0)
+            return false;
+
+        ::close(fd);
+        return true;
+    }();
+
+    return supported;
+}
+
+auto IoUring::owned() const noexcept -> bool
+{
+    return generation_ == fork_generation.load(std::memory_order_relaxed);
+}
+
+auto IoUring::unmap() noexcept -> void
+{
+    if (sqes_ != nullptr)
+        ::munmap(sqes_, sqes_size_);
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+        ::munmap(cq_ring_, cq_ring_size_);
+    if (sq_ring_ != nullptr)
+        ::munmap(sq_ring_, sq_ring_size_);
+
+    ::close(ring_fd_);
+}
+
+auto IoUring::direction_for(AsyncIoOperation& op) -> Direction&
+{
+    auto const fd = op.get_fd();
+    EXIOS_EXPECT(fd >= 0);
+    auto const index = static_cast<std::size_t>(fd);
+    if (index >= slots_.size())
+        slots_.resize(std::max(index + 1, slots_.size() * 2));
+
+    auto& slot = slots_[index];
+    if (op.is_error_queue_operation())
+        return slot.errors;
+
+    return op.is_read_operation() ? slot.reads : slot.writes;
+}
+
+auto IoUring::unsubmitted() const noexcept -> std::uint32_t
+{
+    return *sq_tail_ - std::atomic_ref { *sq_head_ }.load(
+                           std::memory_order_acquire);
+}
+
+auto IoUring::flush() noexcept -> void
+{
+    auto const to_submit = unsubmitted();
+    if (to_submit == 0)
+        return;
+
+    [[maybe_unused]] auto const r = enter(ring_fd_, to_submit, 0, 0);
+    EXIOS_EXPECT(r >= 0 || errno == EINTR || errno == EAGAIN ||
+                 errno == EBUSY);
+}
+
+auto IoUring::push(io_uring_sqe const& sqe) noexcept -> void
+{
+    /* If the submission queue is full then hand what we have to the
+     * kernel to make space...
+     */
+    if (unsubmitted() == sq_entries_)
+        flush();
+
+    EXIOS_EXPECT(unsubmitted() < sq_entries_);
+
+    auto const tail = *sq_tail_;
+    auto const index = tail & sq_mask_;
+    sqes_[index] = sqe;
+    sq_array_[index] = index;
+
+    /* The kernel mustn't see the new tail until the entry has been
+     * written...
+     */
+    std::atomic_ref { *sq_tail_ }.store(tail + 1, std::memory_order_release);
+}
+
+auto IoUring::submit_front(Direction& direction) noexcept -> void
+{
+    if (direction.queue.empty() || direction.submission != Submission::none)
+        return;
+
+    auto& op = direction.queue.front();
+    io_uring_sqe sqe {};
+    op.prepare_submission(sqe);
+    sqe.user_data = encode(&op, kOperationTag);
+    push(sqe);
+
+    direction.submission = Submission::operation;
+    in_flight_ += 1;
+}
+
+auto IoUring::submit_poll(Direction& direction) noexcept -> void
+{
+    EXIOS_EXPECT(!direction.queue.empty());
+    EXIOS_EXPECT(direction.submission == Submission::none);
+
+    auto& op = direction.queue.front();
+    io_uring_sqe sqe {};
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = op.get_fd();
+    if (op.is_error_queue_operation())
+        sqe.poll32_events = POLLERR;
+    else
+        sqe.poll32_events = op.is_read_operation() ? POLLIN : POLLOUT;
+    sqe.user_data = encode(&op, kPollTag);
+    push(sqe);
+
+    direction.submission = Submission::poll;
+    in_flight_ += 1;
+}
+
+auto IoUring::submit_cancel(std::uint64_t user_data) noexcept -> void
+{
+    io_uring_sqe sqe {};
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.fd = -1;
+    sqe.addr = user_data;
+    sqe.user_data = kCancelTag;
+    push(sqe);
+}
+
+auto IoUring::arm_wake() noexcept -> void
+{
+    io_uring_sqe sqe {};
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = wake_event_.get_fd();
+    sqe.poll32_events = POLLIN;
+    sqe.user_data = encode(nullptr, kWakeTag);
+    push(sqe);
+
+    in_flight_ += 1;
+}
+
+auto IoUring::empty() const noexcept -> bool
+{
+    return poll_queue_length_ == 0;
+}
+
+auto IoUring::schedule(AsyncIoOperation* op, bool speculative) noexcept
+    -> void
+{
+    std::lock_guard lock { data_mutex_ };
+    EXIOS_EXPECT(owned());
+
+    /* As with the epoll backend, the operation fails if the table can't
+     * grow to fit its FD...
+     */
+    Direction* direction_ptr = nullptr;
+    try {
+        direction_ptr = &direction_for(*op);
+    }
+    catch (std::bad_alloc const&) {
+        op->fail(ENOMEM);
+        op->get_context().post(op);
+        return;
+    }
+
+    auto& direction = *direction_ptr;
+
+    if (speculative && direction.queue.empty() && op->perform_io()) {
+        op->get_context().post(op);
+        return;
+    }
+
+    direction.queue.push_back(op);
+    poll_queue_length_ += 1;
+    submit_front(direction);
+
+    /* Submissions are normally passed to the kernel by the next call to
+     * `poll_once()`. Threads that are already blocked won't see this
+     * one, though, so we pass it on ourselves...
+     */
+    if (waiters_ > 0)
+        flush();
+}
+
+auto IoUring::cancel(int fd) noexcept -> void
+{
+    std::lock_guard lock { data_mutex_ };
+
+    if (!owned())
+        return;
+
+    if (fd < 0 || static_cast<std::size_t>(fd) >= slots_.size())
+        return;
+
+    auto& slot = slots_[static_cast<std::size_t>(fd)];
+    for (auto* direction : { &slot.reads, &slot.writes, &slot.errors }) {
+        auto& queue = direction->queue;
+        if (queue.empty())
+            continue;
+
+        /* The submitted operation stays where it is until the kernel
+         * tells us it's done with it. The kernel may still finish the I/O,
+         * so it's only given its cancelled result once we know it didn't.
+         * Everything behind it can be completed on the next call to
+         * `poll_once`...
+         */
+        auto first = queue.begin();
+        if (direction->submission != Submission::none) {
+            auto const tag = direction->submission == Submission::operation
+                                 ? kOperationTag
+                                 : kPollTag;
+            queue.front().request_cancel();
+            submit_cancel(encode(&queue.front(), tag));
+            first = std::next(first);
+        }
+
+        std::for_each(first, queue.end(), [](auto& item) { item.cancel(); });
+
+        static_cast<void>(
+            cancelled_.splice(cancelled_.end(), queue, first, queue.end()));
+    }
+
+    if (waiters_ > 0)
+        flush();
+}
+
+auto IoUring::reap() noexcept -> std::size_t
+{
+    std::size_t num_processed = 0;
+
+    auto head = *cq_head_;
+    auto const tail =
+        std::atomic_ref { *cq_tail_ }.load(std::memory_order_acquire);
+
+    for (; head != tail; ++head)
+        num_processed += process_completion(cqes_[head & cq_mask_]);
+
+    std::atomic_ref { *cq_head_ }.store(head, std::memory_order_release);
+
+    return num_processed;
+}
+
+auto IoUring::process_completion(io_uring_cqe const& cqe) noexcept
+    -> std::size_t
+{
+    auto const tag = cqe.user_data & kTagMask;
+    if (tag == kCancelTag)
+        return 0;
+
+    in_flight_ -= 1;
+
+    if (tag == kWakeTag) {
+        wake_event_.reset();
+        if (!stopping_)
+            arm_wake();
+
+        return 0;
+    }
+
+    auto& op = decode(cqe.user_data);
+    auto& direction = direction_for(op);
+    EXIOS_EXPECT(&direction.queue.front() == &op);
+    direction.submission = Submission::none;
+
+    /* Everything is discarded by the destructor...
+     */
+    if (stopping_)
+        return 0;
+
+    /* An operation cancelled while it was submitted still gets the
+     * result of any I/O the kernel performed before the cancellation took
+     * effect; E.g. data it had already read from a socket, which would
+     * otherwise be lost...
+     */
+    auto const performed =
+        tag == kOperationTag &&
+        !(op.cancelled() && cqe.res == -ECANCELED) &&
+        op.complete_submission(cqe.res);
+
+    if (!performed && op.cancelled())
+        op.cancel();
+
+    if (performed || op.cancelled()) {
+        /* WARNING: As with the epoll backend, the operation must leave
+         * its queue _BEFORE_ it's posted...
+         */
+        direction.queue.pop_front();
+        op.get_context().post(&op);
+        submit_front(direction);
+        return 1;
+    }
+
+    /* The operation would have blocked, so wait for the FD to become
+     * ready. Once it is, the operation is submitted again...
+     */
+    if (tag == kOperationTag)
+        submit_poll(direction);
+    else
+        submit_front(direction);
+
+    return 0;
+}
+
+auto IoUring::poll_once(bool block) -> std::size_t
+{
+    std::size_t num_cancelled = 0;
+    std::uint32_t to_submit = 0;
+
+    /* NOTE:
+     * As with the epoll backend, we don't block if we've processed any
+     * cancellations...
+     */
+    bool wait = false;
+
+    {
+        std::lock_guard lock { data_mutex_ };
+        EXIOS_EXPECT(owned());
+        num_cancelled = process_cancellations(cancelled_);
+
+        EXIOS_EXPECT(cancelled_.empty());
+        decrement_count(poll_queue_length_, num_cancelled);
+
+        if (poll_queue_length_ == 0)
+            return 0;
+
+        to_submit = unsubmitted();
+        wait = block && num_cancelled == 0;
+        if (wait)
+            waiters_ += 1;
+    }
+
+    /* Without anything to submit or wait for, completions can be
+     * reaped without entering the kernel at all...
+     */
+    if (wait || to_submit > 0) {
+        auto const r = enter(ring_fd_,
+                             to_submit,
+                             wait ? 1 : 0,
+                             wait ? IORING_ENTER_GETEVENTS : 0);
+        auto const error = errno;
+
+        if (wait)
+            waiters_ -= 1;
+
+        if (r < 0 && error != EINTR && error != EAGAIN && error != EBUSY)
+            throw std::system_error { error, std::system_category() };
+    }
+
+    std::lock_guard lock { data_mutex_ };
+    auto const num_processed = reap();
+    decrement_count(poll_queue_length_, num_processed);
+
+    return num_processed;
+}
+
+} // namespace exios
@@ -0,0 +1,216 @@
+#include "exios/recycling_allocator.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace
+{
+
+/* Freed blocks are handed out again before this many more are cached by
+ * a thread; The rest are moved to the pool's shared list in batches...
+ */
+constexpr std::size_t kThreadCacheLimit = 64;
+constexpr std::size_t kBatchSize = kThreadCacheLimit / 2;
+
+/* Beyond this, the shared list returns blocks to the heap rather than
+ * holding on to the memory of a past burst forever...
+ */
+constexpr std::size_t kSharedLimit = 1024;
+
+thread_local bool thread_cache_destroyed = false;
+
+auto size_class(std::size_t size) noexcept -> std::size_t
+{
+    if (size <= exios::RecyclingPool::kMinBlockSize)
+        return 0;
+
+    constexpr auto kMinWidth =
+        std::bit_width(exios::RecyclingPool::kMinBlockSize - 1);
+
+    return static_cast<std::size_t>(std::bit_width(size - 1) - kMinWidth);
+}
+
+auto block_size(std::size_t size_class) noexcept -> std::size_t
+{
+    return exios::RecyclingPool::kMinBlockSize << size_class;
+}
+
+auto is_pooled(std::size_t size, std::size_t alignment) noexcept -> bool
+{
+    return size <= exios::RecyclingPool::kMaxBlockSize &&
+           alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+auto heap_allocate(std::size_t size, std::size_t alignment) -> void*
+{
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return ::operator new(size, std::align_val_t { alignment });
+
+    return ::operator new(size);
+}
+
+auto heap_deallocate(void* ptr, std::size_t alignment) noexcept -> void
+{
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        ::operator delete(ptr, std::align_val_t { alignment });
+    else
+        ::operator delete(ptr);
+}
+
+} // namespace
+
+namespace exios
+{
+
+/* Blocks in each size class are interchangeable between pools, so a
+ * single cache per thread serves every pool that thread uses...
+ */
+struct RecyclingPool::ThreadCache
+{
+    ThreadCache() noexcept = default;
+    ThreadCache(ThreadCache const&) = delete;
+    auto operator=(ThreadCache const&) -> ThreadCache& = delete;
+
+    ~ThreadCache()
+    {
+        for (auto& list : lists) {
+            while (list.head != nullptr)
+                ::operator delete(std::exchange(list.head, list.head->next));
+        }
+
+        thread_cache_destroyed = true;
+    }
+
+    std::array<FreeList, kNumClasses> lists {};
+};
+
+RecyclingPool::~RecyclingPool()
+{
+    for (auto& list : shared_) {
+        while (list.head != nullptr)
+            ::operator delete(std::exchange(list.head, list.head->next));
+    }
+}
+
+auto RecyclingPool::thread_cache() noexcept -> ThreadCache*
+{
+    /* Operations may still be freed while the thread's cache is being
+     * destroyed, E.g. from other thread-local destructors...
+     */
+    if (thread_cache_destroyed)
+        return nullptr;
+
+    thread_local ThreadCache cache;
+    return &cache;
+}
+
+auto RecyclingPool::do_allocate(std::size_t size, std::size_t alignment)
+    -> void*
+{
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!is_pooled(size, alignment)) {
+        heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+        return heap_allocate(size, alignment);
+    }
+
+    auto const c = size_class(size);
+    FreeList uncached {};
+    auto* cache = thread_cache();
+    auto& list = cache != nullptr ? cache->lists[c] : uncached;
+
+    if (list.head == nullptr)
+        refill(c, list, cache != nullptr ? kBatchSize : 1);
+
+    if (list.head != nullptr) {
+        recycled_.fetch_add(1, std::memory_order_relaxed);
+        list.size -= 1;
+        return std::exchange(list.head, list.head->next);
+    }
+
+    heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(block_size(c));
+}
+
+auto RecyclingPool::do_deallocate(void* ptr,
+                                  std::size_t size,
+                                  std::size_t alignment) -> void
+{
+    if (!is_pooled(size, alignment)) {
+        heap_deallocate(ptr, alignment);
+        return;
+    }
+
+    auto const c = size_class(size);
+    FreeList uncached {};
+    auto* cache = thread_cache();
+    auto& list = cache != nullptr ? cache->lists[c] : uncached;
+
+    auto* block = ::new (ptr) FreeBlock { list.head };
+    list.head = block;
+    list.size += 1;
+
+    if (cache == nullptr)
+        spill(c, list, list.size);
+    else if (list.size > kThreadCacheLimit)
+        spill(c, list, kBatchSize);
+}
+
+auto RecyclingPool::do_is_equal(
+    std::pmr::memory_resource const& other) const noexcept -> bool
+{
+    return this == &other;
+}
+
+auto RecyclingPool::stats() const noexcept -> RecyclingPoolStats
+{
+    return RecyclingPoolStats {
+        .allocations = allocations_.load(std::memory_order_relaxed),
+        .recycled = recycled_.load(std::memory_order_relaxed),
+        .heap_allocations = heap_allocations_.load(std::memory_order_relaxed),
+    };
+}
+
+auto RecyclingPool::refill(std::size_t size_class,
+                           FreeList& into,
+                           std::size_t max) noexcept -> void
+{
+    std::lock_guard lock { mutex_ };
+    auto& shared = shared_[size_class];
+
+    for (; max > 0 && shared.head != nullptr; --max) {
+        auto* block = std::exchange(shared.head, shared.head->next);
+        shared.size -= 1;
+        block->next = into.head;
+        into.head = block;
+        into.size += 1;
+    }
+}
+
+auto RecyclingPool::spill(std::size_t size_class,
+                          FreeList& from,
+                          std::size_t count) noexcept -> void
+{
+    {
+        std::lock_guard lock { mutex_ };
+        auto& shared = shared_[size_class];
+
+        for (; count > 0 && shared.size < kSharedLimit; --count) {
+            auto* block = std::exchange(from.head, from.head->next);
+            from.size -= 1;
+            block->next = shared.head;
+            shared.head = block;
+            shared.size += 1;
+        }
+    }
+
+    for (; count > 0; --count) {
+        from.size -= 1;
+        ::operator delete(std::exchange(from.head, from.head->next));
+    }
+}
+
+} // namespace exios
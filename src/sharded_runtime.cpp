@@ -0,0 +1,253 @@
+#include "exios/sharded_runtime.hpp"
+#include "exios/async_operation.hpp"
+#include "exios/context_thread.hpp"
+#include "exios/contracts.hpp"
+#include "exios/scope_guard.hpp"
+#include "exios/spsc_ring.hpp"
+#include "exios/work.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+thread_local exios::ShardedRuntime const* current_runtime = nullptr;
+thread_local std::size_t current_index = 0;
+
+auto allowed_cpus() -> std::vector<int>
+{
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) < 0)
+        return cpus;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set))
+            cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+auto pin_to_cpu(int cpu) noexcept -> void
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    /* Pinning is an optimisation; The shard still runs if it fails...
+     */
+    static_cast<void>(
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set));
+}
+
+} // namespace
+
+namespace exios
+{
+
+struct ShardedRuntime::Shard
+{
+    /* Posted to the shard's context to deliver everything waiting in
+     * the shard's incoming rings. It's owned by the shard, so it's never
+     * deallocated...
+     */
+    struct DrainOperation final : AnyAsyncOperation
+    {
+        DrainOperation(ShardedRuntime& runtime, std::size_t index) noexcept
+            : AnyAsyncOperation { &DrainOperation::thunk }
+            , runtime_ { runtime }
+            , index_ { index }
+        {
+        }
+
+    private:
+        static auto thunk(AnyAsyncOperation& op, OperationAction action, void*)
+            -> bool
+        {
+            auto& self = static_cast<DrainOperation&>(op);
+            if (action == OperationAction::dispatch)
+                self.runtime_.drain(self.index_);
+
+            return true;
+        }
+
+        ShardedRuntime& runtime_;
+        std::size_t index_;
+    };
+
+    Shard(ShardedRuntime& runtime, std::size_t index)
+        : drain_operation { runtime, index }
+    {
+    }
+
+    ContextThread context;
+    DrainOperation drain_operation;
+    std::atomic_bool drain_scheduled { false };
+    std::optional<Work<ContextThread>> work;
+    std::thread thread;
+};
+
+ShardedRuntime::ShardedRuntime(std::size_t num_shards,
+                               bool pin_threads,
+                               std::size_t ring_capacity)
+{
+    EXIOS_EXPECT(num_shards > 0);
+
+    shards_.reserve(num_shards);
+    for (std::size_t i = 0; i < num_shards; ++i)
+        shards_.push_back(std::make_unique<Shard>(*this, i));
+
+    /* There's a ring for every ordered pair of distinct shards. Posts
+     * from a shard to itself go straight to its context...
+     */
+    rings_.resize(num_shards * num_shards);
+    for (std::size_t from = 0; from < num_shards; ++from) {
+        for (std::size_t to = 0; to < num_shards; ++to) {
+            if (from != to) {
+                rings_[from * num_shards + to] =
+                    std::make_unique<SpscRing<AnyAsyncOperation>>(
+                        ring_capacity);
+            }
+        }
+    }
+
+    auto const cpus = pin_threads ? allowed_cpus() : std::vector<int> {};
+
+    for (auto& shard : shards_)
+        shard->work.emplace(shard->context);
+
+    try {
+        for (std::size_t i = 0; i < num_shards; ++i) {
+            auto const cpu =
+                cpus.empty() ? std::optional<int> {}
+                             : std::optional<int> { cpus[i % cpus.size()] };
+
+            shards_[i]->thread = std::thread { [this, i, cpu] {
+                if (cpu)
+                    pin_to_cpu(*cpu);
+
+                current_runtime = this;
+                current_index = i;
+                static_cast<void>(shards_[i]->context.run());
+            } };
+        }
+    }
+    catch (...) {
+        stop();
+        for (auto& shard : shards_) {
+            if (shard->thread.joinable())
+                shard->thread.join();
+        }
+        throw;
+    }
+}
+
+ShardedRuntime::~ShardedRuntime()
+{
+    stop();
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable())
+            shard->thread.join();
+    }
+
+    for (auto& r : rings_) {
+        if (!r)
+            continue;
+
+        while (auto* op = r->try_pop())
+            discard(std::move(*op));
+    }
+}
+
+auto ShardedRuntime::size() const noexcept -> std::size_t
+{
+    return shards_.size();
+}
+
+auto ShardedRuntime::shard(std::size_t index) noexcept -> ContextThread&
+{
+    EXIOS_EXPECT(index < shards_.size());
+    return shards_[index]->context;
+}
+
+auto ShardedRuntime::current_shard() noexcept -> std::optional<std::size_t>
+{
+    if (current_runtime == nullptr)
+        return std::nullopt;
+
+    return current_index;
+}
+
+auto ShardedRuntime::stop() noexcept -> void
+{
+    for (auto& shard : shards_)
+        shard->work.reset();
+}
+
+auto ShardedRuntime::ring(std::size_t from, std::size_t to) noexcept
+    -> SpscRing<AnyAsyncOperation>&
+{
+    return *rings_[from * shards_.size() + to];
+}
+
+auto ShardedRuntime::deliver(std::size_t index, AnyAsyncOperation* op) noexcept
+    -> void
+{
+    EXIOS_EXPECT(index < shards_.size());
+    auto& target = *shards_[index];
+
+    /* Posts from other threads, and posts that don't fit in the ring, go
+     * through the target's completion queue...
+     */
+    if (current_runtime != this || current_index == index ||
+        !ring(current_index, index).try_push(op)) {
+        target.context.post(op);
+        return;
+    }
+
+    /* Pairs with the fence in `drain()`; Either the target sees our item
+     * or we see that it needs to drain again...
+     */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (!target.drain_scheduled.load(std::memory_order_relaxed) &&
+        !target.drain_scheduled.exchange(true)) {
+        target.context.post(&target.drain_operation);
+    }
+}
+
+auto ShardedRuntime::drain(std::size_t index) -> void
+{
+    auto& shard = *shards_[index];
+    shard.drain_scheduled = false;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    /* If a handler throws then the rest are delivered by another drain,
+     * once the exception has been dealt with...
+     */
+    bool drained = false;
+    EXIOS_SCOPE_GUARD([&] {
+        if (!drained && !shard.drain_scheduled.exchange(true))
+            shard.context.post(&shard.drain_operation);
+    });
+
+    for (std::size_t from = 0; from < shards_.size(); ++from) {
+        if (from == index)
+            continue;
+
+        auto& incoming = ring(from, index);
+        while (auto* op = incoming.try_pop())
+            dispatch(std::move(*op));
+    }
+
+    drained = true;
+}
+
+} // namespace exios
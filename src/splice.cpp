@@ -0,0 +1,29 @@
+#include "exios/splice.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace exios::detail
+{
+
+SplicePipe::SplicePipe()
+{
+    int fds[2];
+    if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) < 0)
+        throw std::system_error { errno, std::system_category() };
+
+    read_fd = fds[0];
+    write_fd = fds[1];
+
+    auto const size = ::fcntl(write_fd, F_GETPIPE_SZ);
+    capacity = size > 0 ? static_cast<std::size_t>(size) : 4096;
+}
+
+SplicePipe::~SplicePipe()
+{
+    ::close(read_fd);
+    ::close(write_fd);
+}
+
+} // namespace exios::detail
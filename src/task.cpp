@@ -0,0 +1,56 @@
+#include "exios/task.hpp"
+#include "exios/context_thread.hpp"
+#include "exios/recycling_allocator.hpp"
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+namespace
+{
+
+/* Keeps the frame itself aligned as `operator new` would...
+ */
+constexpr std::size_t kFramePrefix = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+static_assert(kFramePrefix >= sizeof(std::pmr::memory_resource*));
+
+} // namespace
+
+namespace exios::detail
+{
+
+auto fallback_frame_resource() noexcept -> std::pmr::memory_resource*
+{
+    if (auto* ctx = ContextThread::current(); ctx != nullptr)
+        return &ctx->recycling_pool();
+
+    return std::pmr::get_default_resource();
+}
+
+auto as_frame_resource(RecyclingPool& pool) noexcept
+    -> std::pmr::memory_resource*
+{
+    return &pool;
+}
+
+auto allocate_frame(std::size_t size, std::pmr::memory_resource* resource)
+    -> void*
+{
+    auto* block = static_cast<std::byte*>(resource->allocate(
+        size + kFramePrefix, __STDCPP_DEFAULT_NEW_ALIGNMENT__));
+
+    ::new (block) std::pmr::memory_resource* { resource };
+    return block + kFramePrefix;
+}
+
+auto deallocate_frame(void* frame, std::size_t size) noexcept -> void
+{
+    auto* block = static_cast<std::byte*>(frame) - kFramePrefix;
+    auto* resource = *std::launder(
+        reinterpret_cast<std::pmr::memory_resource**>(block));
+
+    resource->deallocate(
+        block, size + kFramePrefix, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+} // namespace exios::detail
@@ -4,6 +4,7 @@
 #include "exios/utils.hpp"
 #include <cstdint>
 #include <errno.h>
+#include <memory>
 #include <sys/socket.h>
 #include <system_error>
 
@@ -24,6 +25,23 @@ TcpSocket::TcpSocket(Context const& ctx, int fd) noexcept
 {
 }
 
+auto TcpSocket::zerocopy_state() -> std::shared_ptr<ZerocopyState>
+{
+    if (zerocopy_)
+        return zerocopy_;
+
+    /* Without `SO_ZEROCOPY`, the kernel silently ignores `MSG_ZEROCOPY`
+     * and never sends the notifications we'd wait for...
+     */
+    int const optval = 1;
+    if (::setsockopt(
+            fd_.value(), SOL_SOCKET, SO_ZEROCOPY, &optval, sizeof(optval)))
+        throw std::system_error { errno, std::system_category() };
+
+    zerocopy_ = std::make_shared<ZerocopyState>();
+    return zerocopy_;
+}
+
 TcpSocketAcceptor::TcpSocketAcceptor(Context const& ctx,
                                      std::uint16_t port,
                                      std::string_view address)
@@ -3,6 +3,7 @@
 #include "exios/utils.hpp"
 #include <cstdint>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #include <sys/socket.h>
 
 namespace exios
@@ -32,4 +33,19 @@ auto UdpSocket::bind(std::uint16_t port, std::string_view address) -> void
     }
 }
 
+auto UdpSocket::enable_gro(bool enabled) -> void
+{
+    int const optval = enabled ? 1 : 0;
+    if (::setsockopt(fd_.value(), SOL_UDP, UDP_GRO, &optval, sizeof(optval)))
+        throw std::system_error { errno, std::system_category() };
+}
+
+auto UdpSocket::set_gso_segment_size(std::uint16_t segment_size) -> void
+{
+    int const optval = segment_size;
+    if (::setsockopt(
+            fd_.value(), SOL_UDP, UDP_SEGMENT, &optval, sizeof(optval)))
+        throw std::system_error { errno, std::system_category() };
+}
+
 } // namespace exios
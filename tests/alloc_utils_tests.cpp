@@ -1,7 +1,41 @@
 #include "exios/exios.hpp"
 #include "testing.hpp"
 #include "tracking_allocator.hpp"
+#include <cstddef>
 #include <iostream>
+#include <memory_resource>
+
+namespace
+{
+
+struct CountingResource : std::pmr::memory_resource
+{
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+
+private:
+    auto do_allocate(std::size_t size, std::size_t alignment)
+        -> void* override
+    {
+        allocations += 1;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    auto do_deallocate(void* ptr, std::size_t size, std::size_t alignment)
+        -> void override
+    {
+        deallocations += 1;
+        std::pmr::new_delete_resource()->deallocate(ptr, size, alignment);
+    }
+
+    auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+        -> bool override
+    {
+        return this == &other;
+    }
+};
+
+} // namespace
 
 auto should_use_custom_allocator_with_timer_io() -> void
 {
@@ -35,7 +69,66 @@ auto should_use_custom_allocator_with_timer_io() -> void
     EXPECT(max_allocations > 0);
 }
 
+auto should_post_work_using_memory_resource() -> void
+{
+    CountingResource resource;
+    exios::ContextThread thread;
+    bool called = false;
+
+    thread.post([&] { called = true; }, &resource);
+    static_cast<void>(thread.run());
+
+    EXPECT(called);
+    EXPECT(resource.allocations == 1);
+    EXPECT(resource.deallocations == 1);
+}
+
+auto should_use_memory_resource_with_timer_io() -> void
+{
+    CountingResource resource;
+    exios::ContextThread thread;
+    exios::Timer timer { thread };
+    bool called = false;
+
+    timer.wait_for_expiry_after(
+        std::chrono::milliseconds(1),
+        exios::use_allocator([&](exios::IoResult&&) { called = true; },
+                             &resource));
+
+    static_cast<void>(thread.run());
+
+    EXPECT(called);
+    EXPECT(resource.allocations > 0);
+    EXPECT(resource.allocations == resource.deallocations);
+}
+
+auto should_use_context_default_resource() -> void
+{
+    CountingResource resource;
+    exios::ContextThread thread;
+    exios::Timer timer { thread };
+
+    thread.set_default_resource(&resource);
+    EXPECT(thread.default_resource() == &resource);
+
+    timer.wait_for_expiry_after(std::chrono::milliseconds(1),
+                                [](exios::IoResult&&) {});
+    thread.post([] {});
+    static_cast<void>(thread.run());
+
+    EXPECT(resource.allocations >= 2);
+    EXPECT(resource.allocations == resource.deallocations);
+
+    thread.set_default_resource(nullptr);
+    EXPECT(thread.default_resource() != &resource);
+}
+
 auto main() -> int
 {
-    return testing::run({ TEST(should_use_custom_allocator_with_timer_io) });
+    return testing::run({
+        TEST(should_use_custom_allocator_with_timer_io),
+        TEST(should_post_work_using_memory_resource),
+        TEST(should_use_memory_resource_with_timer_io),
+        TEST(should_use_context_default_resource),
+    });
 }
@@ -125,10 +125,22 @@ auto should_behave_in_intrusive_list() -> void
     discard(std::move(*op));
 }
 
+auto should_keep_operation_headers_within_budget() -> void
+{
+    /* The list links and the thunk...
+     */
+    EXPECT(sizeof(exios::AnyAsyncOperation) <= 3 * sizeof(void*));
+
+    /* ...plus the context, the FD and the flags...
+     */
+    EXPECT(sizeof(exios::AsyncIoOperation) <= 5 * sizeof(void*));
+}
+
 auto main() -> int
 {
     return testing::run({ TEST(should_make_async_io_operation),
                           TEST(should_invoke_async_io_operation),
                           TEST(should_deallocate_before_invocation),
-                          TEST(should_behave_in_intrusive_list) });
+                          TEST(should_behave_in_intrusive_list),
+                          TEST(should_keep_operation_headers_within_budget) });
 }
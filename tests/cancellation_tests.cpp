@@ -1,7 +1,25 @@
 #include "exios/exios.hpp"
 #include "testing.hpp"
 #include <chrono>
+#include <cstddef>
 #include <iostream>
+#include <string_view>
+
+using namespace std::literals::string_view_literals;
+
+namespace
+{
+
+/* Runs any pending completions, and then polls for I/O without
+ * blocking...
+ */
+auto poll_without_blocking(exios::ContextThread& thread) -> void
+{
+    thread.post([&] { thread.post([] {}); });
+    static_cast<void>(thread.run_once());
+}
+
+} // namespace
 
 auto should_cancel_timer() -> void
 {
@@ -76,9 +94,86 @@ auto should_cancel_other_timers() -> void
     static_cast<void>(thread.run());
 }
 
+auto should_only_cancel_the_given_fd() -> void
+{
+    exios::ContextThread thread;
+    exios::Timer cancelled_timer { thread };
+    exios::Timer timer { thread };
+
+    bool cancelled = false;
+    bool expired = false;
+
+    cancelled_timer.wait_for_expiry_after(
+        std::chrono::milliseconds(5000), [&](auto&& result) {
+            cancelled = result.is_error_value() &&
+                        result.error() == std::errc::operation_canceled;
+        });
+
+    timer.wait_for_expiry_after(std::chrono::milliseconds(10),
+                                [&](auto&& result) { expired = !!result; });
+
+    cancelled_timer.cancel();
+
+    static_cast<void>(thread.run());
+
+    EXPECT(cancelled);
+    EXPECT(expired);
+}
+
+auto should_keep_data_read_before_cancel() -> void
+{
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "cancel_read"sv };
+    exios::UnixSocket client { thread };
+    exios::UnixSocket server { thread };
+
+    acceptor.accept(server, [](auto const& result) { EXPECT(result); });
+    client.connect("cancel_read"sv,
+                   [](auto const& result) { EXPECT(result); });
+    static_cast<void>(thread.run());
+
+    char data = 'x';
+    char received = 0;
+    std::size_t num_read = 0;
+    bool cancelled = false;
+
+    auto on_read = [&](exios::IoResult result) {
+        if (result)
+            num_read += result.value();
+        else
+            cancelled = result.error() == std::errc::operation_canceled;
+    };
+
+    /* The read is handed to the kernel before the data arrives, so with
+     * io_uring it completes there before we see the cancellation...
+     */
+    server.read(exios::BufferView { &received, 1 }, on_read);
+    poll_without_blocking(thread);
+    poll_without_blocking(thread);
+
+    client.write(exios::ConstBufferView { &data, 1 },
+                 [](auto const& result) { EXPECT(result); });
+    server.cancel();
+    static_cast<void>(thread.run());
+
+    /* Whichever way the race went, the data is delivered exactly once;
+     * Either to the cancelled read, or to the next one...
+     */
+    if (num_read == 0) {
+        EXPECT(cancelled);
+        server.read(exios::BufferView { &received, 1 }, on_read);
+        static_cast<void>(thread.run());
+    }
+
+    EXPECT(num_read == 1);
+    EXPECT(received == data);
+}
+
 auto main() -> int
 {
     return testing::run({ TEST(should_cancel_timer),
                           TEST(should_cancel_other_timers),
-                          TEST(should_cancel_all_previous_timer_waits) });
+                          TEST(should_cancel_all_previous_timer_waits),
+                          TEST(should_only_cancel_the_given_fd),
+                          TEST(should_keep_data_read_before_cancel) });
 }
@@ -0,0 +1,234 @@
+#include "exios/exios.hpp"
+#include "testing.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <semaphore>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+namespace
+{
+
+struct CountingResource : std::pmr::memory_resource
+{
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+
+    auto do_allocate(std::size_t size, std::size_t alignment) -> void* override
+    {
+        allocations += 1;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    auto do_deallocate(void* ptr, std::size_t size, std::size_t alignment)
+        -> void override
+    {
+        deallocations += 1;
+        std::pmr::new_delete_resource()->deallocate(ptr, size, alignment);
+    }
+
+    auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+        -> bool override
+    {
+        return this == &other;
+    }
+};
+
+auto wait_on(exios::Timer& timer, std::chrono::milliseconds duration)
+{
+    return exios::defer<exios::TimerOrEventIoResult>(
+        timer, [&timer, duration](auto&& completion) {
+            timer.wait_for_expiry_after(duration, std::move(completion));
+        });
+}
+
+auto wait_on(exios::Event& event)
+{
+    return exios::defer<exios::TimerOrEventIoResult>(
+        event, [&event](auto&& completion) {
+            event.wait_for_event(std::move(completion));
+        });
+}
+
+} // namespace
+
+auto should_complete_when_all_operations_finish() -> void
+{
+    exios::ContextThread thread;
+    exios::Timer first { thread };
+    exios::Timer second { thread };
+    std::size_t calls = 0;
+
+    exios::when_all(
+        thread,
+        [&](auto results) {
+            EXPECT(std::get<0>(results));
+            EXPECT(std::get<1>(results));
+            calls += 1;
+        },
+        wait_on(first, std::chrono::milliseconds(1)),
+        wait_on(second, std::chrono::milliseconds(5)));
+
+    static_cast<void>(thread.run());
+
+    EXPECT(calls == 1);
+}
+
+auto should_complete_with_the_first_operation_to_finish() -> void
+{
+    exios::ContextThread thread;
+    exios::Event event { thread };
+    exios::Timer timer { thread };
+    std::size_t calls = 0;
+
+    exios::when_any(
+        thread,
+        [&](auto result) {
+            EXPECT(result.index() == 1);
+            EXPECT(std::get<1>(result));
+            calls += 1;
+        },
+        wait_on(event),
+        wait_on(timer, std::chrono::milliseconds(1)));
+
+    /* The event is never triggered; `run()` only returns once its wait
+     * has been cancelled...
+     */
+    static_cast<void>(thread.run());
+
+    EXPECT(calls == 1);
+}
+
+auto should_cancel_operations_that_lose() -> void
+{
+    exios::ContextThread thread;
+    exios::Timer fast { thread };
+    exios::Timer slow { thread };
+    std::size_t calls = 0;
+
+    auto const start = std::chrono::steady_clock::now();
+
+    exios::when_any(
+        thread,
+        [&](auto result) {
+            EXPECT(result.index() == 0);
+            calls += 1;
+        },
+        wait_on(fast, std::chrono::milliseconds(1)),
+        wait_on(slow, std::chrono::milliseconds(5000)));
+
+    static_cast<void>(thread.run());
+
+    EXPECT(calls == 1);
+    EXPECT(std::chrono::steady_clock::now() - start <
+           std::chrono::milliseconds(1000));
+}
+
+auto should_cancel_operations_started_after_the_winner() -> void
+{
+    constexpr std::size_t kRounds = 50;
+
+    exios::ContextThread thread;
+    exios::Timer timer { thread };
+    exios::Event event { thread };
+    std::optional<exios::Work<exios::ContextThread>> work { thread };
+    std::atomic_size_t calls = 0;
+
+    std::vector<std::thread> threads(4);
+    for (auto& t : threads)
+        t = std::thread { [&] { static_cast<void>(thread.run()); } };
+
+    /* A zero-length wait completes straight away, possibly on another
+     * thread, before the event's wait has even started...
+     */
+    for (std::size_t i = 0; i < kRounds; ++i) {
+        std::binary_semaphore done { 0 };
+
+        exios::when_any(
+            thread,
+            [&](auto result) {
+                EXPECT(result.index() == 0);
+                calls += 1;
+                done.release();
+            },
+            wait_on(timer, std::chrono::milliseconds(0)),
+            wait_on(event));
+
+        done.acquire();
+    }
+
+    work.reset();
+    for (auto& t : threads)
+        t.join();
+
+    EXPECT(calls == kRounds);
+}
+
+auto should_allocate_a_single_shared_state() -> void
+{
+    CountingResource resource;
+    exios::ContextThread thread;
+    exios::Timer first { thread };
+    exios::Timer second { thread };
+    exios::Timer third { thread };
+    bool called = false;
+
+    exios::when_all(
+        thread,
+        exios::use_allocator([&](auto) { called = true; }, &resource),
+        wait_on(first, std::chrono::milliseconds(1)),
+        wait_on(second, std::chrono::milliseconds(1)),
+        wait_on(third, std::chrono::milliseconds(1)));
+
+    static_cast<void>(thread.run());
+
+    EXPECT(called);
+    EXPECT(resource.allocations == 1);
+    EXPECT(resource.deallocations == 1);
+}
+
+auto should_deliver_result_after_freeing_state() -> void
+{
+    exios::ContextThread thread;
+    exios::Event event { thread };
+    exios::Timer timer { thread };
+    std::size_t calls = 0;
+
+    /* A resource that frees straight away, rather than recycling, so a
+     * completion reading from the freed state is caught by ASan...
+     */
+    exios::when_any(
+        thread,
+        exios::use_allocator(
+            [&](auto result) {
+                EXPECT(result.index() == 1);
+                EXPECT(std::get<1>(result));
+                calls += 1;
+            },
+            std::pmr::new_delete_resource()),
+        wait_on(event),
+        wait_on(timer, std::chrono::milliseconds(1)));
+
+    static_cast<void>(thread.run());
+
+    EXPECT(calls == 1);
+}
+
+auto main() -> int
+{
+    return testing::run({
+        TEST(should_complete_when_all_operations_finish),
+        TEST(should_complete_with_the_first_operation_to_finish),
+        TEST(should_cancel_operations_that_lose),
+        TEST(should_cancel_operations_started_after_the_winner),
+        TEST(should_allocate_a_single_shared_state),
+        TEST(should_deliver_result_after_freeing_state),
+    });
+}
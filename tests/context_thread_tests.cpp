@@ -1,8 +1,11 @@
 #include "exios/exios.hpp"
 #include "testing.hpp"
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <iostream>
+#include <mutex>
+#include <set>
 #include <stdexcept>
 #include <thread>
 #include <vector>
@@ -116,9 +119,83 @@ auto should_be_exception_safe_multi_threaded() -> void
     EXPECT(completed == 4);
 }
 
+auto should_wake_idle_threads_for_posted_work() -> void
+{
+    constexpr std::size_t kNumPosts = 10'000;
+
+    exios::ContextThread thread;
+    exios::Work<exios::ContextThread> work { thread };
+
+    std::atomic_size_t completed = 0;
+
+    std::vector<std::thread> runners(4);
+    for (auto& t : runners)
+        t = std::thread { [&] { static_cast<void>(thread.run()); } };
+
+    std::vector<std::thread> producers(4);
+    for (auto& t : producers) {
+        t = std::thread { [&] {
+            for (std::size_t i = 0; i < kNumPosts; ++i)
+                thread.post([&] { completed += 1; });
+        } };
+    }
+
+    for (auto& t : producers)
+        t.join();
+
+    thread.post([&] { work.reset(); });
+
+    for (auto& t : runners)
+        t.join();
+
+    EXPECT(completed == kNumPosts * producers.size());
+}
+
+auto should_steal_work_posted_by_another_runner() -> void
+{
+    constexpr std::size_t kNumTasks = 200;
+
+    exios::ContextThread thread;
+    exios::Work<exios::ContextThread> work { thread };
+
+    std::mutex mutex;
+    std::set<std::thread::id> thread_ids;
+    std::atomic_size_t completed = 0;
+
+    /* All of the tasks are posted from one runner, so they're queued
+     * locally to it. They can only run elsewhere if they're stolen...
+     */
+    thread.post([&] {
+        for (std::size_t i = 0; i < kNumTasks; ++i) {
+            thread.post([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                {
+                    std::lock_guard lock { mutex };
+                    thread_ids.insert(std::this_thread::get_id());
+                }
+
+                if (completed.fetch_add(1) + 1 == kNumTasks)
+                    work.reset();
+            });
+        }
+    });
+
+    std::vector<std::thread> runners(4);
+    for (auto& t : runners)
+        t = std::thread { [&] { static_cast<void>(thread.run()); } };
+
+    for (auto& t : runners)
+        t.join();
+
+    EXPECT(completed == kNumTasks);
+    EXPECT(thread_ids.size() > 1);
+}
+
 auto main() -> int
 {
     return testing::run({ TEST(should_be_exception_safe),
                           TEST(should_only_throw_on_run),
-                          TEST(should_be_exception_safe_multi_threaded) });
+                          TEST(should_be_exception_safe_multi_threaded),
+                          TEST(should_wake_idle_threads_for_posted_work),
+                          TEST(should_steal_work_posted_by_another_runner) });
 }
@@ -0,0 +1,266 @@
+#include "exios/exios.hpp"
+#include "testing.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+
+struct CountingResource : std::pmr::memory_resource
+{
+    std::size_t allocations = 0;
+
+private:
+    auto do_allocate(std::size_t size, std::size_t alignment)
+        -> void* override
+    {
+        allocations += 1;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    auto do_deallocate(void* ptr, std::size_t size, std::size_t alignment)
+        -> void override
+    {
+        std::pmr::new_delete_resource()->deallocate(ptr, size, alignment);
+    }
+
+    auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+        -> bool override
+    {
+        return this == &other;
+    }
+};
+
+auto add(int a, int b) -> exios::Task<int> { co_return a + b; }
+
+auto sum(int& out) -> exios::Task<>
+{
+    auto const first = co_await add(1, 2);
+    auto const second = co_await add(first, 3);
+    out = second;
+}
+
+auto wait_for_timer(exios::Timer& timer, bool& expired) -> exios::Task<>
+{
+    auto const result = co_await timer.async_wait_for_expiry_after(
+        std::chrono::milliseconds(1));
+    EXPECT(result);
+    expired = true;
+}
+
+auto signal_event(exios::Event& event) -> exios::Task<>
+{
+    auto const result = co_await event.async_trigger_with_value(2);
+    EXPECT(result);
+}
+
+auto wait_for_event(exios::Event& event, std::uint64_t& value)
+    -> exios::Task<>
+{
+    auto const result = co_await event.async_wait_for_event();
+    EXPECT(result);
+    value = result.value();
+}
+
+auto throw_error() -> exios::Task<>
+{
+    throw std::runtime_error { "error" };
+    co_return;
+}
+
+auto count(exios::ContextThread&, std::size_t& counted) -> exios::Task<>
+{
+    counted += 1;
+    co_return;
+}
+
+auto server(exios::UnixSocketAcceptor& acceptor,
+            exios::UnixSocket& socket) -> exios::Task<>
+{
+    auto const accepted = co_await acceptor.async_accept(socket);
+    EXPECT(accepted);
+
+    std::array<char, 16> buffer {};
+    for (;;) {
+        auto const read = co_await socket.async_read(
+            exios::BufferView { buffer.data(), buffer.size() });
+        EXPECT(read);
+        if (read.value() == 0)
+            co_return;
+
+        auto const written = co_await socket.async_write(
+            exios::ConstBufferView { buffer.data(), read.value() });
+        EXPECT(written);
+    }
+}
+
+auto client(exios::UnixSocket& socket, std::size_t& echoed) -> exios::Task<>
+{
+    auto const connected = co_await socket.async_connect("coroutine_test"sv);
+    EXPECT(connected);
+
+    constexpr auto kMessage = "hello"sv;
+    std::array<char, 16> buffer {};
+
+    for (auto i = 0; i < 3; ++i) {
+        auto const written = co_await socket.async_write(
+            exios::ConstBufferView { kMessage.data(), kMessage.size() });
+        EXPECT(written);
+
+        auto const read = co_await socket.async_read(
+            exios::BufferView { buffer.data(), buffer.size() });
+        EXPECT(read);
+        EXPECT(std::string_view(buffer.data(), read.value()) == kMessage);
+        echoed += 1;
+    }
+
+    socket.close();
+}
+
+auto await_oversized_operation(exios::ContextThread& thread,
+                               std::pmr::memory_resource& resource)
+    -> exios::Task<>
+{
+    auto const result = co_await exios::make_io_awaitable<int>(
+        std::pmr::polymorphic_allocator<std::byte> { &resource },
+        [&thread](auto&& completion) {
+            constexpr std::size_t kOversized = 512;
+            auto alloc = completion.get_allocator();
+            auto* p = alloc.allocate(kOversized);
+            alloc.deallocate(p, kOversized);
+            thread.post([completion]() mutable { completion(1); });
+        });
+    EXPECT(result == 1);
+}
+
+} // namespace
+
+auto should_await_nested_tasks() -> void
+{
+    exios::ContextThread thread;
+    int result = 0;
+
+    exios::spawn(thread, sum(result));
+    EXPECT(result == 0);
+
+    static_cast<void>(thread.run());
+    EXPECT(result == 6);
+}
+
+auto should_await_timer() -> void
+{
+    exios::ContextThread thread;
+    exios::Timer timer { thread };
+    bool expired = false;
+
+    exios::spawn(thread, wait_for_timer(timer, expired));
+    static_cast<void>(thread.run());
+
+    EXPECT(expired);
+}
+
+auto should_await_events() -> void
+{
+    exios::ContextThread thread;
+    exios::Event event { thread };
+    std::uint64_t value = 0;
+
+    exios::spawn(thread, wait_for_event(event, value));
+    exios::spawn(thread, signal_event(event));
+    static_cast<void>(thread.run());
+
+    EXPECT(value == 2);
+}
+
+auto should_rethrow_task_exceptions_from_run() -> void
+{
+    exios::ContextThread thread;
+    exios::spawn(thread, throw_error());
+
+    bool thrown = false;
+    try {
+        static_cast<void>(thread.run());
+    }
+    catch (std::runtime_error const&) {
+        thrown = true;
+    }
+
+    EXPECT(thrown);
+}
+
+auto should_echo_over_unix_sockets_without_allocating_operations() -> void
+{
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "coroutine_test"sv };
+    exios::UnixSocket server_socket { thread };
+    exios::UnixSocket client_socket { thread };
+    std::size_t echoed = 0;
+
+    exios::spawn(thread, server(acceptor, server_socket));
+    exios::spawn(thread, client(client_socket, echoed));
+
+    /* Operations that don't fit in their awaitable fall back to the
+     * sockets' allocator, and so to the context's default resource...
+     */
+    CountingResource resource;
+    thread.set_default_resource(&resource);
+    static_cast<void>(thread.run());
+    thread.set_default_resource(nullptr);
+
+    EXPECT(echoed == 3);
+    EXPECT(resource.allocations == 0);
+}
+
+auto should_allocate_oversized_operations_from_the_given_allocator() -> void
+{
+    exios::ContextThread thread;
+    CountingResource resource;
+
+    exios::spawn(thread, await_oversized_operation(thread, resource));
+    static_cast<void>(thread.run());
+
+    EXPECT(resource.allocations == 1);
+}
+
+auto should_recycle_coroutine_frames() -> void
+{
+    exios::ContextThread thread;
+    constexpr std::size_t kTasks = 100;
+    std::size_t counted = 0;
+
+    for (auto i = 0u; i < kTasks; ++i)
+        exios::spawn(thread, count(thread, counted));
+    static_cast<void>(thread.run());
+
+    auto const before = thread.allocation_stats();
+
+    for (auto i = 0u; i < kTasks; ++i)
+        exios::spawn(thread, count(thread, counted));
+    static_cast<void>(thread.run());
+
+    auto const after = thread.allocation_stats();
+
+    EXPECT(counted == 2 * kTasks);
+    EXPECT(after.allocations - before.allocations >= kTasks);
+    EXPECT(after.heap_allocations == before.heap_allocations);
+}
+
+auto main() -> int
+{
+    return testing::run({
+        TEST(should_await_nested_tasks),
+        TEST(should_await_timer),
+        TEST(should_await_events),
+        TEST(should_rethrow_task_exceptions_from_run),
+        TEST(should_echo_over_unix_sockets_without_allocating_operations),
+        TEST(should_allocate_oversized_operations_from_the_given_allocator),
+        TEST(should_recycle_coroutine_frames),
+    });
+}
@@ -1,5 +1,7 @@
 #include "exios/exios.hpp"
 #include "testing.hpp"
+#include <memory_resource>
+#include <system_error>
 
 auto should_trigger_event() -> void
 {
@@ -53,8 +55,65 @@ auto should_operate_in_semaphore_mode() -> void
     EXPECT(events_delivered == 2);
 }
 
+auto should_trigger_event_with_persistent_registration() -> void
+{
+    exios::ContextThread thread;
+    exios::Event event { thread };
+    event.enable_persistent_registration();
+
+    constexpr std::size_t kMaxEvents = 3;
+    std::size_t events_delivered = 0;
+    std::size_t events_posted = 0;
+
+    auto wait = [&](auto& self) -> void {
+        event.wait_for_event([&, self](auto result) {
+            EXPECT(!result.is_error_value());
+            if (++events_delivered < kMaxEvents) {
+                self(self);
+                event.trigger([&](auto r) {
+                    EXPECT(!r.is_error_value());
+                    events_posted += 1;
+                });
+            }
+        });
+    };
+
+    wait(wait);
+
+    event.trigger([&](auto result) {
+        EXPECT(!result.is_error_value());
+        events_posted += 1;
+    });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(events_posted == kMaxEvents);
+    EXPECT(events_delivered == kMaxEvents);
+}
+
+auto should_fail_wait_when_fd_table_cannot_grow() -> void
+{
+    /* The scheduler's table starts empty, so the first operation needs it
+     * to grow...
+     */
+    exios::ContextThread thread { exios::default_io_backend(),
+                                  std::pmr::null_memory_resource() };
+    exios::Event event { thread };
+
+    bool failed = false;
+    event.wait_for_event([&](exios::TimerOrEventIoResult result) {
+        failed = !result && result.error() == std::errc::not_enough_memory;
+    });
+
+    static_cast<void>(thread.run());
+    EXPECT(failed);
+}
+
 auto main() -> int
 {
     return testing::run(
-        { TEST(should_trigger_event), TEST(should_operate_in_semaphore_mode) });
+        { TEST(should_trigger_event),
+          TEST(should_operate_in_semaphore_mode),
+          TEST(should_trigger_event_with_persistent_registration),
+          TEST(should_fail_wait_when_fd_table_cannot_grow) });
 }
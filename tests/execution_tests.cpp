@@ -0,0 +1,156 @@
+#include "exios/exios.hpp"
+#include "testing.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+
+constexpr auto kMessage = "hello"sv;
+
+struct Outcome
+{
+    std::size_t values = 0;
+    std::size_t errors = 0;
+    std::size_t stops = 0;
+};
+
+template <typename F>
+struct TestReceiver
+{
+    template <typename... Args>
+    auto set_value(Args&&... args) -> void
+    {
+        f(std::forward<Args>(args)...);
+        outcome->values += 1;
+    }
+
+    auto set_error(std::error_code) -> void { outcome->errors += 1; }
+    auto set_stopped() -> void { outcome->stops += 1; }
+
+    F f;
+    Outcome* outcome;
+};
+
+template <typename F>
+auto receiver(Outcome& outcome, F f) -> TestReceiver<F>
+{
+    return TestReceiver<F> { std::move(f), &outcome };
+}
+
+} // namespace
+
+auto should_complete_scheduled_work_from_run() -> void
+{
+    exios::ContextThread thread;
+    Outcome outcome;
+    bool ran = false;
+
+    auto const scheduler = exios::Context { thread }.get_scheduler();
+    auto op = exios::connect(scheduler.schedule(),
+                             receiver(outcome, [&] { ran = true; }));
+
+    exios::start(op);
+    EXPECT(!ran);
+
+    static_cast<void>(thread.run());
+
+    EXPECT(ran);
+    EXPECT(outcome.values == 1);
+}
+
+auto should_fuse_then_without_allocating() -> void
+{
+    exios::ContextThread thread;
+    exios::Timer timer { thread };
+    Outcome outcome;
+    std::uint64_t result = 0;
+
+    auto const before = thread.allocation_stats();
+
+    auto op = exios::connect(
+        timer.wait_for_expiry_after_sender(std::chrono::milliseconds(1)) |
+            exios::then([](std::uint64_t expirations) {
+                return expirations * 10;
+            }),
+        receiver(outcome, [&](std::uint64_t value) { result = value; }));
+
+    exios::start(op);
+    static_cast<void>(thread.run());
+
+    auto const after = thread.allocation_stats();
+
+    EXPECT(outcome.values == 1);
+    EXPECT(result == 10);
+    EXPECT(after.allocations == before.allocations);
+}
+
+auto should_chain_operations_with_let_value() -> void
+{
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "execution_test"sv };
+    exios::UnixSocket client { thread };
+    std::array<char, 16> buffer {};
+    Outcome server_outcome;
+    Outcome client_outcome;
+    std::size_t received = 0;
+
+    auto server = exios::connect(
+        acceptor.accept_sender() |
+            exios::let_value([&](exios::UnixSocket& socket) {
+                return socket.read_sender(
+                    exios::BufferView { buffer.data(), buffer.size() });
+            }),
+        receiver(server_outcome, [&](std::size_t n) { received = n; }));
+
+    auto sender = exios::connect(
+        client.connect_sender("execution_test"sv) | exios::let_value([&] {
+            return client.write_sender(
+                exios::ConstBufferView { kMessage.data(), kMessage.size() });
+        }),
+        receiver(client_outcome, [](std::size_t n) {
+            EXPECT(n == kMessage.size());
+        }));
+
+    exios::start(server);
+    exios::start(sender);
+    static_cast<void>(thread.run());
+
+    EXPECT(server_outcome.values == 1);
+    EXPECT(client_outcome.values == 1);
+    EXPECT(std::string_view(buffer.data(), received) == kMessage);
+}
+
+auto should_complete_cancelled_operations_with_stopped() -> void
+{
+    exios::ContextThread thread;
+    exios::Event event { thread };
+    Outcome outcome;
+
+    auto op = exios::connect(event.wait_for_event_sender(),
+                             receiver(outcome, [](std::uint64_t) {}));
+
+    exios::start(op);
+    event.cancel();
+    static_cast<void>(thread.run());
+
+    EXPECT(outcome.values == 0);
+    EXPECT(outcome.stops == 1);
+}
+
+auto main() -> int
+{
+    return testing::run({
+        TEST(should_complete_scheduled_work_from_run),
+        TEST(should_fuse_then_without_allocating),
+        TEST(should_chain_operations_with_let_value),
+        TEST(should_complete_cancelled_operations_with_stopped),
+    });
+}
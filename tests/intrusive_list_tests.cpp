@@ -1,3 +1,4 @@
+#include "exios/atomic_intrusive_list.hpp"
 #include "exios/exios.hpp"
 #include "exios/intrusive_list.hpp"
 #include "testing.hpp"
@@ -7,6 +8,7 @@
 #include <iterator>
 #include <limits>
 #include <random>
+#include <thread>
 #include <vector>
 
 struct TestListItem : exios::ListItemBase
@@ -225,6 +227,74 @@ auto should_sort_insert_from_random_elements() -> void
     }
 }
 
+auto should_move_construct_list() -> void
+{
+    std::array<TestListItem, 3> items { TestListItem(1),
+                                        TestListItem(2),
+                                        TestListItem(3) };
+
+    exios::IntrusiveList<TestListItem> list;
+    for (auto& item : items)
+        list.push_back(&item);
+
+    exios::IntrusiveList<TestListItem> moved_to { std::move(list) };
+
+    EXPECT(list.empty());
+    EXPECT(!moved_to.empty());
+    EXPECT(moved_to.front().value == 1);
+    EXPECT(moved_to.back().value == 3);
+
+    int expected = 1;
+    EXPECT(check_loop(
+        moved_to.begin(), moved_to.end(), items.size(), [&](auto const& item) {
+            EXPECT(item.value == expected++);
+        }));
+}
+
+auto should_take_all_items_pushed_concurrently() -> void
+{
+    constexpr std::size_t kNumProducers = 4;
+    constexpr std::size_t kItemsPerProducer = 1000;
+
+    std::vector<TestListItem> items(kNumProducers * kItemsPerProducer);
+    for (std::size_t i = 0; i < items.size(); ++i)
+        items[i].value = static_cast<int>(i);
+
+    exios::AtomicIntrusiveList<TestListItem> list;
+    EXPECT(list.empty());
+
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < kNumProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (std::size_t i = 0; i < kItemsPerProducer; ++i)
+                static_cast<void>(
+                    list.push_back(&items[p * kItemsPerProducer + i]));
+        });
+    }
+
+    for (auto& producer : producers)
+        producer.join();
+
+    EXPECT(!list.empty());
+    auto taken = list.take_all();
+    EXPECT(list.empty());
+
+    /* Items from each producer must come out in the order they were
+     * pushed...
+     */
+    std::vector<int> last_seen(kNumProducers, -1);
+    std::size_t count = 0;
+    for (auto const& item : taken) {
+        auto const producer =
+            static_cast<std::size_t>(item.value) / kItemsPerProducer;
+        EXPECT(item.value > last_seen[producer]);
+        last_seen[producer] = item.value;
+        ++count;
+    }
+
+    EXPECT(count == items.size());
+}
+
 auto main() -> int
 {
     return testing::run({ TEST(should_splice_items_in_same_list),
@@ -232,5 +302,7 @@ auto main() -> int
                           TEST(should_splice_single_item_in_same_list),
                           TEST(should_splice_whole_list_onto_itself),
                           TEST(should_sort_insert_lots_of_elements),
-                          TEST(should_sort_insert_from_random_elements) });
+                          TEST(should_sort_insert_from_random_elements),
+                          TEST(should_move_construct_list),
+                          TEST(should_take_all_items_pushed_concurrently) });
 }
@@ -0,0 +1,187 @@
+#include "exios/exios.hpp"
+#include "testing.hpp"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <string_view>
+
+namespace
+{
+
+struct CountingResource : std::pmr::memory_resource
+{
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+
+private:
+    auto do_allocate(std::size_t size, std::size_t alignment)
+        -> void* override
+    {
+        allocations += 1;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    auto do_deallocate(void* ptr, std::size_t size, std::size_t alignment)
+        -> void override
+    {
+        deallocations += 1;
+        std::pmr::new_delete_resource()->deallocate(ptr, size, alignment);
+    }
+
+    auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+        -> bool override
+    {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+auto should_reset_once_every_allocation_is_returned() -> void
+{
+    CountingResource upstream;
+    auto* arena = exios::IoArena::create(256, &upstream);
+
+    auto* first = arena->allocate(64);
+    auto* second = arena->allocate(64);
+    EXPECT(first != second);
+
+    arena->deallocate(first, 64);
+    arena->deallocate(second, 64);
+
+    /* Nothing is live, so the arena starts again from the beginning...
+     */
+    auto* third = arena->allocate(64);
+    EXPECT(third == first);
+    arena->deallocate(third, 64);
+
+    arena->release();
+    EXPECT(upstream.allocations == 0);
+}
+
+auto should_fall_back_to_upstream_when_full() -> void
+{
+    CountingResource upstream;
+    auto* arena = exios::IoArena::create(128, &upstream);
+
+    /* One allocation fills each half...
+     */
+    auto* first = arena->allocate(48);
+    auto* second = arena->allocate(48);
+    auto* third = arena->allocate(48);
+    EXPECT(upstream.allocations == 1);
+
+    /* The arena outlives its release while allocations are live...
+     */
+    arena->release();
+    arena->deallocate(third, 48);
+    arena->deallocate(second, 48);
+    arena->deallocate(first, 48);
+
+    EXPECT(upstream.deallocations == 1);
+}
+
+auto should_reuse_one_half_while_the_other_is_held() -> void
+{
+    CountingResource upstream;
+    auto* arena = exios::IoArena::create(256, &upstream);
+
+    /* `held` is never returned, so its half never resets...
+     */
+    auto* held = arena->allocate(64);
+    for (auto i = 0; i < 16; ++i) {
+        auto* ptr = arena->allocate(64);
+        arena->deallocate(ptr, 64);
+    }
+
+    EXPECT(upstream.allocations == 0);
+
+    arena->deallocate(held, 64);
+    arena->release();
+}
+
+auto should_allocate_object_operations_from_arena() -> void
+{
+    CountingResource fallback;
+    exios::ContextThread thread;
+    thread.set_default_resource(&fallback);
+
+    exios::Timer timer { thread };
+    timer.enable_arena();
+
+    std::size_t expired = 0;
+    for (auto i = 0; i < 4; ++i) {
+        timer.wait_for_expiry_after(std::chrono::milliseconds(1),
+                                    [&](auto&& result) {
+                                        EXPECT(result);
+                                        expired += 1;
+                                    });
+        static_cast<void>(thread.run());
+    }
+
+    EXPECT(expired == 4);
+    EXPECT(fallback.allocations == 0);
+
+    /* Closing the object drops the arena...
+     */
+    timer.close();
+    EXPECT(timer.get_allocator().resource() == &fallback);
+}
+
+auto should_keep_allocating_from_arena_with_read_pending() -> void
+{
+    using namespace std::literals::string_view_literals;
+
+    CountingResource fallback;
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "arena"sv };
+    exios::UnixSocket client { thread };
+    exios::UnixSocket target { thread };
+
+    acceptor.accept(target, [](auto const& result) { EXPECT(result); });
+    client.connect("arena"sv, [](auto const& result) { EXPECT(result); });
+    static_cast<void>(thread.run());
+
+    thread.set_default_resource(&fallback);
+    target.enable_arena();
+
+    /* The client never writes, so the read stays pending throughout...
+     */
+    char in = 0;
+    bool cancelled = false;
+    target.read(exios::BufferView { &in, 1 }, [&](exios::IoResult result) {
+        cancelled = !result;
+    });
+
+    char const out = 'x';
+    std::size_t written = 0;
+    std::function<void()> write = [&] {
+        target.write(exios::ConstBufferView { &out, 1 },
+                     [&](exios::IoResult result) {
+                         EXPECT(result);
+                         if (++written < 64)
+                             write();
+                         else
+                             target.cancel();
+                     });
+    };
+
+    write();
+    static_cast<void>(thread.run());
+
+    EXPECT(written == 64);
+    EXPECT(cancelled);
+    EXPECT(fallback.allocations == 0);
+}
+
+auto main() -> int
+{
+    return testing::run({
+        TEST(should_reset_once_every_allocation_is_returned),
+        TEST(should_fall_back_to_upstream_when_full),
+        TEST(should_reuse_one_half_while_the_other_is_held),
+        TEST(should_allocate_object_operations_from_arena),
+        TEST(should_keep_allocating_from_arena_with_read_pending),
+    });
+}
@@ -2,6 +2,7 @@
 #include "testing.hpp"
 #include <atomic>
 #include <iostream>
+#include <memory>
 #include <sys/sysinfo.h>
 #include <thread>
 #include <vector>
@@ -58,7 +59,40 @@ auto should_expire_timer_on_background_thread() -> void
     EXPECT((kMaxRequests - expired_count) == cancelled_count);
 }
 
+auto should_complete_io_with_multiple_runners() -> void
+{
+    constexpr std::size_t kNumTimers = 16;
+
+    exios::ContextThread thread;
+    exios::Work<exios::ContextThread> work { thread };
+
+    std::vector<std::unique_ptr<exios::Timer>> timers;
+    for (std::size_t i = 0; i < kNumTimers; ++i)
+        timers.push_back(std::make_unique<exios::Timer>(thread));
+
+    std::vector<std::thread> threads(4);
+    for (auto& t : threads)
+        t = std::thread { [&] { static_cast<void>(thread.run()); } };
+
+    std::atomic_size_t expired_count = 0;
+
+    for (auto& timer : timers) {
+        timer->wait_for_expiry_after(
+            std::chrono::milliseconds(10), [&](auto const& result) {
+                EXPECT(result);
+                if (expired_count.fetch_add(1) + 1 == kNumTimers)
+                    work.reset();
+            });
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    EXPECT(expired_count == kNumTimers);
+}
+
 auto main() -> int
 {
-    return testing::run({ TEST(should_expire_timer_on_background_thread) });
+    return testing::run({ TEST(should_expire_timer_on_background_thread),
+                          TEST(should_complete_io_with_multiple_runners) });
 }
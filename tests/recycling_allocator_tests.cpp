@@ -0,0 +1,117 @@
+#include "exios/exios.hpp"
+#include "testing.hpp"
+#include <array>
+#include <cstddef>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+auto should_recycle_freed_blocks() -> void
+{
+    exios::RecyclingPool pool;
+    exios::RecyclingAllocator<std::array<char, 100>> alloc { pool };
+
+    auto* first = alloc.allocate(1);
+    alloc.deallocate(first, 1);
+    auto* second = alloc.allocate(1);
+    alloc.deallocate(second, 1);
+
+    EXPECT(first == second);
+
+    auto const stats = pool.stats();
+    EXPECT(stats.allocations == 2);
+    EXPECT(stats.recycled == 1);
+    EXPECT(stats.heap_allocations == 1);
+}
+
+auto should_use_the_heap_for_large_allocations() -> void
+{
+    exios::RecyclingPool pool;
+    exios::RecyclingAllocator<char> alloc { pool };
+
+    for (auto i = 0; i < 4; ++i) {
+        auto* p = alloc.allocate(exios::RecyclingPool::kMaxBlockSize + 1);
+        alloc.deallocate(p, exios::RecyclingPool::kMaxBlockSize + 1);
+    }
+
+    auto const stats = pool.stats();
+    EXPECT(stats.recycled == 0);
+    EXPECT(stats.heap_allocations == 4);
+}
+
+auto should_recycle_blocks_freed_on_another_thread() -> void
+{
+    constexpr std::size_t kBatch = 256;
+    constexpr std::size_t kRounds = 16;
+
+    exios::RecyclingPool pool;
+    exios::RecyclingAllocator<std::array<char, 64>> alloc { pool };
+
+    std::vector<std::array<char, 64>*> blocks;
+    std::binary_semaphore allocated { 0 };
+    std::binary_semaphore freed { 0 };
+
+    std::thread consumer { [&] {
+        for (std::size_t round = 0; round < kRounds; ++round) {
+            allocated.acquire();
+            for (auto* block : blocks)
+                alloc.deallocate(block, 1);
+            freed.release();
+        }
+    } };
+
+    std::size_t warm_heap_allocations = 0;
+    for (std::size_t round = 0; round < kRounds; ++round) {
+        if (round == 2)
+            warm_heap_allocations = pool.stats().heap_allocations;
+
+        blocks.clear();
+        for (std::size_t i = 0; i < kBatch; ++i)
+            blocks.push_back(alloc.allocate(1));
+
+        allocated.release();
+        freed.acquire();
+    }
+
+    consumer.join();
+
+    /* Once the consumer's cache is full, everything it frees makes its
+     * way back to the producer...
+     */
+    auto const stats = pool.stats();
+    EXPECT(stats.allocations == kBatch * kRounds);
+    EXPECT(stats.heap_allocations == warm_heap_allocations);
+}
+
+auto should_not_use_the_heap_for_posted_work_in_steady_state() -> void
+{
+    exios::ContextThread ctx;
+    std::size_t count = 0;
+
+    auto const post_and_run = [&] {
+        for (auto i = 0; i < 100; ++i)
+            ctx.post([&] { count += 1; });
+
+        static_cast<void>(ctx.run());
+    };
+
+    post_and_run();
+    auto const warm = ctx.allocation_stats();
+
+    post_and_run();
+    auto const stats = ctx.allocation_stats();
+
+    EXPECT(count == 200);
+    EXPECT(stats.allocations == warm.allocations + 100);
+    EXPECT(stats.heap_allocations == warm.heap_allocations);
+}
+
+auto main() -> int
+{
+    return testing::run({
+        TEST(should_recycle_freed_blocks),
+        TEST(should_use_the_heap_for_large_allocations),
+        TEST(should_recycle_blocks_freed_on_another_thread),
+        TEST(should_not_use_the_heap_for_posted_work_in_steady_state),
+    });
+}
@@ -0,0 +1,82 @@
+#include "exios/exios.hpp"
+#include "testing.hpp"
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <vector>
+
+auto should_run_work_on_the_target_shard() -> void
+{
+    constexpr std::size_t kNumShards = 4;
+
+    exios::ShardedRuntime runtime { kNumShards };
+    EXPECT(runtime.size() == kNumShards);
+    EXPECT(!exios::ShardedRuntime::current_shard());
+
+    std::vector<std::promise<std::size_t>> ran_on(kNumShards);
+    for (std::size_t i = 0; i < kNumShards; ++i) {
+        runtime.post_to(i, [&, i] {
+            ran_on[i].set_value(*exios::ShardedRuntime::current_shard());
+        });
+    }
+
+    for (std::size_t i = 0; i < kNumShards; ++i)
+        EXPECT(ran_on[i].get_future().get() == i);
+}
+
+auto should_deliver_cross_shard_work_in_order() -> void
+{
+    constexpr std::size_t kNumPosts = 1000;
+
+    exios::ShardedRuntime runtime { 2 };
+
+    std::vector<std::size_t> received;
+    std::promise<void> done;
+
+    runtime.post_to(0, [&] {
+        for (std::size_t i = 0; i < kNumPosts; ++i) {
+            runtime.post_to(1, [&, i] {
+                EXPECT(exios::ShardedRuntime::current_shard() == 1u);
+                received.push_back(i);
+                if (received.size() == kNumPosts)
+                    done.set_value();
+            });
+        }
+    });
+
+    done.get_future().wait();
+
+    for (std::size_t i = 0; i < kNumPosts; ++i)
+        EXPECT(received[i] == i);
+}
+
+auto should_fall_back_to_the_completion_queue_when_a_ring_is_full() -> void
+{
+    constexpr std::size_t kNumPosts = 1000;
+
+    exios::ShardedRuntime runtime { 2, false, 4 };
+
+    std::size_t received = 0;
+    std::promise<void> done;
+
+    runtime.post_to(0, [&] {
+        for (std::size_t i = 0; i < kNumPosts; ++i) {
+            runtime.post_to(1, [&] {
+                if (++received == kNumPosts)
+                    done.set_value();
+            });
+        }
+    });
+
+    done.get_future().wait();
+    EXPECT(received == kNumPosts);
+}
+
+auto main() -> int
+{
+    return testing::run({
+        TEST(should_run_work_on_the_target_shard),
+        TEST(should_deliver_cross_shard_work_in_order),
+        TEST(should_fall_back_to_the_completion_queue_when_a_ring_is_full),
+    });
+}
@@ -0,0 +1,213 @@
+#include "exios/exios.hpp"
+#include "testing.hpp"
+#include "tracking_allocator.hpp"
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+using namespace std::literals::string_view_literals;
+
+namespace
+{
+
+/* Two connected pairs of sockets: `client` -> `upstream`, and
+ * `downstream` -> `sink`. The splice runs from `upstream` to
+ * `downstream`...
+ */
+struct Proxy
+{
+    explicit Proxy(exios::ContextThread& thread)
+        : acceptor_in { thread, "splice_in"sv }
+        , acceptor_out { thread, "splice_out"sv }
+        , client { thread }
+        , upstream { thread }
+        , downstream { thread }
+        , sink { thread }
+    {
+    }
+
+    template <typename F>
+    auto connect(F&& on_connected) -> void
+    {
+        auto accepted = [this, on_connected](auto const& result) mutable {
+            EXPECT(result);
+            if (++connected == 2)
+                on_connected();
+        };
+
+        acceptor_in.accept(upstream, accepted);
+        acceptor_out.accept(sink, accepted);
+        client.connect("splice_in"sv,
+                       [](auto const& result) { EXPECT(result); });
+        downstream.connect("splice_out"sv,
+                           [](auto const& result) { EXPECT(result); });
+    }
+
+    exios::UnixSocketAcceptor acceptor_in;
+    exios::UnixSocketAcceptor acceptor_out;
+    exios::UnixSocket client;
+    exios::UnixSocket upstream;
+    exios::UnixSocket downstream;
+    exios::UnixSocket sink;
+    int connected = 0;
+};
+
+} // namespace
+
+auto should_splice_until_end_of_stream() -> void
+{
+    constexpr std::size_t kSize = 1024 * 1024;
+
+    exios::ContextThread thread;
+    Proxy proxy { thread };
+
+    std::vector<char> out(kSize);
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i] = static_cast<char>(i % 251);
+
+    std::vector<char> in(kSize);
+    std::size_t spliced = 0;
+    std::size_t received = 0;
+
+    proxy.connect([&] {
+        exios::splice_between(
+            proxy.upstream, proxy.downstream, [&](exios::IoResult result) {
+                EXPECT(result);
+                spliced = result.value();
+            });
+
+        proxy.sink.read_exactly(exios::BufferView { in.data(), in.size() },
+                                [&](exios::IoResult result) {
+                                    EXPECT(result);
+                                    received = result.value();
+                                });
+
+        /* Closing the client ends the stream the splice is reading...
+         */
+        proxy.client.write_all(
+            exios::ConstBufferView { out.data(), out.size() },
+            [&](exios::IoResult result) {
+                EXPECT(result);
+                proxy.client.close();
+            });
+    });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(spliced == kSize);
+    EXPECT(received == kSize);
+    EXPECT(in == out);
+}
+
+auto should_only_allocate_splice_state() -> void
+{
+    constexpr std::size_t kSize = 1024 * 1024;
+
+    exios::ContextThread thread;
+    Proxy proxy { thread };
+
+    std::vector<char> out(kSize);
+    std::vector<char> in(kSize);
+    std::size_t spliced = 0;
+    std::size_t allocations = 0;
+
+    auto alloc_callback = [&](bool allocating, std::size_t) {
+        if (allocating)
+            ++allocations;
+    };
+
+    proxy.connect([&] {
+        exios::splice_between(
+            proxy.upstream,
+            proxy.downstream,
+            exios::use_allocator(
+                [&](exios::IoResult result) {
+                    EXPECT(result);
+                    spliced = result.value();
+                },
+                tracking_allocator<void>(alloc_callback)));
+
+        proxy.sink.read_exactly(exios::BufferView { in.data(), in.size() },
+                                [](exios::IoResult result) {
+                                    EXPECT(result);
+                                });
+
+        proxy.client.write_all(
+            exios::ConstBufferView { out.data(), out.size() },
+            [&](exios::IoResult result) {
+                EXPECT(result);
+                proxy.client.close();
+            });
+    });
+
+    static_cast<void>(thread.run());
+
+    /* The whole stream takes many chunks, but only the state is allocated
+     * with the completion's allocator...
+     */
+    EXPECT(spliced == kSize);
+    EXPECT(allocations == 1);
+}
+
+auto should_complete_splice_when_cancelled() -> void
+{
+    exios::ContextThread thread;
+    Proxy proxy { thread };
+
+    bool completed = false;
+
+    proxy.connect([&] {
+        exios::splice_between(
+            proxy.upstream, proxy.downstream, [&](exios::IoResult result) {
+                EXPECT(!result);
+                EXPECT(result.error() == std::errc::operation_canceled);
+                completed = true;
+            });
+
+        proxy.upstream.cancel();
+    });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(completed);
+}
+
+auto should_cancel_splice_from_destination() -> void
+{
+    exios::ContextThread thread;
+    Proxy proxy { thread };
+
+    bool completed = false;
+
+    proxy.connect([&] {
+        exios::splice_between(
+            proxy.upstream, proxy.downstream, [&](exios::IoResult result) {
+                EXPECT(!result);
+                EXPECT(result.error() == std::errc::operation_canceled);
+                completed = true;
+
+                /* The splice has already let go of both objects...
+                 */
+                proxy.upstream.cancel();
+                proxy.downstream.cancel();
+            });
+
+        /* Nothing has been sent, so the splice is waiting on `upstream`
+         * rather than the object being cancelled...
+         */
+        proxy.downstream.cancel();
+    });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(completed);
+}
+
+auto main() -> int
+{
+    return testing::run({ TEST(should_splice_until_end_of_stream),
+                          TEST(should_only_allocate_splice_state),
+                          TEST(should_complete_splice_when_cancelled),
+                          TEST(should_cancel_splice_from_destination) });
+}
@@ -1,7 +1,9 @@
 #include "exios/exios.hpp"
 #include "exios/io.hpp"
 #include "testing.hpp"
+#include <cstddef>
 #include <cstdio>
+#include <vector>
 #include <thread>
 
 auto should_create_acceptor_on_localhost() -> void
@@ -28,7 +30,60 @@ auto should_create_acceptor_on_localhost() -> void
     EXPECT(accepted);
 }
 
+auto should_notify_when_zerocopy_buffer_is_released() -> void
+{
+    exios::ContextThread ctx;
+    exios::TcpSocketAcceptor acceptor { ctx, 8081, "127.0.0.1" };
+    exios::TcpSocket sender { ctx };
+    exios::TcpSocket receiver { ctx };
+
+    std::vector<char> const outgoing(64 * 1024, 'x');
+    std::vector<char> incoming(outgoing.size());
+
+    std::size_t sent = 0;
+    std::size_t received = 0;
+    int released = 0;
+
+    auto send = [&] {
+        sender.send_zerocopy(
+            exios::ConstBufferView { outgoing.data(), outgoing.size() },
+            [&](exios::IoResult result) {
+                EXPECT(result);
+                EXPECT(released == 0);
+                sent = result.value();
+                receiver.read_exactly(
+                    exios::BufferView { incoming.data(), sent },
+                    [&](exios::IoResult r) {
+                        EXPECT(r);
+                        received = r.value();
+                    });
+            },
+            [&](exios::ZerocopyReleaseResult result) {
+                EXPECT(result);
+                EXPECT(sent > 0);
+                ++released;
+            });
+    };
+
+    acceptor.accept(receiver, [&](auto result) {
+        EXPECT(!result.is_error_value());
+        send();
+    });
+
+    sender.connect("127.0.0.1", 8081, [&](exios::ConnectResult result) {
+        EXPECT(result);
+    });
+
+    static_cast<void>(ctx.run());
+
+    EXPECT(sent > 0);
+    EXPECT(received == sent);
+    EXPECT(released == 1);
+}
+
 auto main() -> int
 {
-    return testing::run({ TEST(should_create_acceptor_on_localhost) });
+    return testing::run(
+        { TEST(should_create_acceptor_on_localhost),
+          TEST(should_notify_when_zerocopy_buffer_is_released) });
 }
@@ -5,11 +5,14 @@
 #include "exios/udp_socket.hpp"
 #include "exios/utils.hpp"
 #include "testing.hpp"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <functional>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 auto should_bind_socket() -> void
 {
@@ -111,9 +114,174 @@ auto should_send_and_receive_bound_and_connected() -> void
     EXPECT(received_message == data);
 }
 
+auto should_send_and_receive_batches() -> void
+{
+    /* More than fit in a single `recvmmsg()` or `sendmmsg()` call...
+     */
+    constexpr std::size_t kDatagrams = 40;
+
+    exios::ContextThread ctx;
+    exios::UdpSocket receiver { ctx };
+    exios::UdpSocket sender { ctx };
+    receiver.bind(1235, "127.0.0.1");
+    sender.bind(1236, "127.0.0.1");
+
+    sockaddr_in destination {};
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr =
+        exios::reverse_byte_order(exios::parse_ipv4("127.0.0.1"));
+    destination.sin_port = exios::reverse_byte_order(std::uint16_t { 1235 });
+
+    std::vector<std::vector<char>> payloads;
+    std::vector<exios::Datagram> datagrams;
+    for (std::size_t i = 0; i < kDatagrams; ++i)
+        payloads.emplace_back(i + 1, static_cast<char>('a' + i % 26));
+    for (auto const& payload : payloads)
+        datagrams.push_back(exios::Datagram {
+            exios::ConstBufferView { payload.data(), payload.size() },
+            destination });
+
+    std::vector<std::vector<char>> buffers(
+        2 * kDatagrams, std::vector<char>(64));
+    std::vector<exios::DatagramSlot> slots;
+    for (auto& buffer : buffers)
+        slots.push_back(exios::DatagramSlot {
+            exios::BufferView { buffer.data(), buffer.size() } });
+
+    std::size_t sent = 0;
+    std::size_t received = 0;
+
+    sender.send_batch(datagrams, [&](exios::IoResult result) {
+        EXPECT(result);
+        sent = result.value();
+
+        /* Loopback delivers each datagram as it's sent, so they're all
+         * waiting for the receive...
+         */
+        receiver.receive_batch(slots, [&](exios::IoResult r) {
+            EXPECT(r);
+            received = r.value();
+        });
+    });
+
+    static_cast<void>(ctx.run());
+
+    EXPECT(sent == kDatagrams);
+    EXPECT(received == kDatagrams);
+
+    for (std::size_t i = 0; i < received; ++i) {
+        auto const& slot = slots[i];
+        EXPECT(slot.size == payloads[i].size());
+        EXPECT(!slot.truncated);
+        EXPECT(std::equal(payloads[i].begin(),
+                          payloads[i].end(),
+                          buffers[i].begin()));
+        EXPECT(exios::reverse_byte_order(slot.address.sin_port) == 1236);
+    }
+}
+
+auto should_segment_and_coalesce() -> void
+{
+    constexpr std::uint16_t kSegmentSize = 1000;
+    constexpr std::size_t kSegments = 4;
+
+    exios::ContextThread ctx;
+    exios::UdpSocket receiver { ctx };
+    exios::UdpSocket sender { ctx };
+    receiver.bind(1237, "127.0.0.1");
+    receiver.enable_gro();
+
+    std::vector<char> out(kSegmentSize * kSegments);
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i] = static_cast<char>(i / kSegmentSize);
+
+    std::vector<char> in(64 * 1024);
+    std::vector<char> received;
+    std::size_t sent = 0;
+
+    /* Whether the segments arrive coalesced depends on the kernel; Either
+     * way, each coalesced payload must be made up of whole segments...
+     */
+    std::function<void()> receive = [&] {
+        receiver.receive_coalesced(
+            exios::BufferView { in.data(), in.size() },
+            [&](exios::ReceiveCoalescedResult result) {
+                EXPECT(result);
+                auto const& datagram = result.value();
+                EXPECT(!datagram.truncated);
+                if (datagram.segment_size != 0)
+                    EXPECT(datagram.segment_size == kSegmentSize);
+                else
+                    EXPECT(datagram.size == kSegmentSize);
+
+                std::fprintf(stderr,
+                             "Received %zu bytes, segment size %u\n",
+                             datagram.size,
+                             static_cast<unsigned>(datagram.segment_size));
+
+                received.insert(received.end(),
+                                in.begin(),
+                                in.begin() + static_cast<std::ptrdiff_t>(
+                                                 datagram.size));
+                if (received.size() < out.size())
+                    receive();
+            });
+    };
+
+    receive();
+    sender.send_segmented_to(
+        exios::ConstBufferView { out.data(), out.size() },
+        kSegmentSize,
+        "127.0.0.1",
+        1237,
+        [&](exios::IoResult result) {
+            EXPECT(result);
+            sent = result.value();
+        });
+
+    static_cast<void>(ctx.run());
+
+    EXPECT(sent == out.size());
+    EXPECT(received == out);
+}
+
+auto should_report_truncated_coalesced_datagram() -> void
+{
+    exios::ContextThread ctx;
+    exios::UdpSocket receiver { ctx };
+    exios::UdpSocket sender { ctx };
+    receiver.bind(1238, "127.0.0.1");
+    receiver.enable_gro();
+
+    std::vector<char> out(100, 'x');
+    std::vector<char> in(10);
+    bool received = false;
+
+    receiver.receive_coalesced(
+        exios::BufferView { in.data(), in.size() },
+        [&](exios::ReceiveCoalescedResult result) {
+            EXPECT(result);
+            EXPECT(result.value().truncated);
+            EXPECT(result.value().size == in.size());
+            received = true;
+        });
+
+    sender.send_to(exios::ConstBufferView { out.data(), out.size() },
+                   "127.0.0.1",
+                   1238,
+                   [](exios::IoResult result) { EXPECT(result); });
+
+    static_cast<void>(ctx.run());
+
+    EXPECT(received);
+}
+
 auto main() -> int
 {
     return testing::run({ TEST(should_bind_socket),
                           TEST(should_send_and_receive),
-                          TEST(should_send_and_receive_bound_and_connected) });
+                          TEST(should_send_and_receive_bound_and_connected),
+                          TEST(should_send_and_receive_batches),
+                          TEST(should_segment_and_coalesce),
+                          TEST(should_report_truncated_coalesced_datagram) });
 }
@@ -2,14 +2,19 @@
 #include "exios/exios.hpp"
 #include "exios/unix_socket.hpp"
 #include "testing.hpp"
+#include <algorithm>
+#include <array>
 #include <fcntl.h>
 #include <filesystem>
 #include <functional>
 #include <iostream>
+#include <signal.h>
 #include <string>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#include <vector>
 
 using namespace std::string_view_literals;
 
@@ -302,11 +307,337 @@ auto should_transfer_file_descriptors() -> void
     EXPECT(content == "test");
 }
 
+auto should_exchange_messages_persistently() -> void
+{
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "test"sv };
+    exios::UnixSocket client { thread };
+    exios::UnixSocket server { thread };
+
+    constexpr std::size_t kNumMessages = 3;
+    std::string const message { "ping" };
+    std::string received(message.size(), '\0');
+    std::size_t num_sent = 0;
+    std::size_t num_received = 0;
+
+    auto send_next = [&](auto& self) -> void {
+        client.write(exios::ConstBufferView { message.data(), message.size() },
+                     [&, self](exios::IoResult result) {
+                         EXPECT(result && result.value() == message.size());
+                         if (++num_sent < kNumMessages)
+                             self(self);
+                     });
+    };
+
+    auto receive_next = [&](auto& self) -> void {
+        server.read(exios::BufferView { received.data(), received.size() },
+                    [&, self](exios::IoResult result) {
+                        EXPECT(result && result.value() == message.size());
+                        EXPECT(received == message);
+                        if (++num_received < kNumMessages)
+                            self(self);
+                    });
+    };
+
+    acceptor.accept(server, [&](auto const& result) {
+        EXPECT(result);
+        server.enable_persistent_registration();
+        receive_next(receive_next);
+    });
+
+    client.enable_persistent_registration();
+    client.connect("test"sv, [&](auto const& result) {
+        EXPECT(result);
+        send_next(send_next);
+    });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(num_sent == kNumMessages);
+    EXPECT(num_received == kNumMessages);
+}
+
+auto should_not_overtake_pending_reads() -> void
+{
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "test"sv };
+    exios::UnixSocket client { thread };
+    exios::UnixSocket server { thread };
+
+    acceptor.accept(server, [](auto const& result) { EXPECT(result); });
+    client.connect("test"sv, [](auto const& result) { EXPECT(result); });
+    static_cast<void>(thread.run());
+
+    char first = '\0';
+    char second = '\0';
+
+    /* No data is available, so the first read is parked...
+     */
+    server.read(exios::BufferView { &first, 1 },
+                [](exios::IoResult result) { EXPECT(result); });
+
+    std::string const message { "ab" };
+    client.write(exios::ConstBufferView { message.data(), message.size() },
+                 [](exios::IoResult result) { EXPECT(result); });
+
+    /* ...Data is now available, but the second read must queue behind the
+     * first rather than speculatively reading it...
+     */
+    server.read(exios::BufferView { &second, 1 },
+                [](exios::IoResult result) { EXPECT(result); });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(first == 'a');
+    EXPECT(second == 'b');
+}
+
+auto should_scatter_and_gather() -> void
+{
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "test"sv };
+    exios::UnixSocket client { thread };
+    exios::UnixSocket target { thread };
+
+    constexpr auto kHeader = "head:"sv;
+    constexpr auto kBody = "body"sv;
+
+    std::array<exios::ConstBufferView, 2> const out {
+        exios::ConstBufferView { kHeader.data(), kHeader.size() },
+        exios::ConstBufferView { kBody.data(), kBody.size() },
+    };
+
+    std::array<char, 5> header {};
+    std::array<char, 16> body {};
+    std::array<exios::BufferView, 2> const in {
+        exios::BufferView { header.data(), header.size() },
+        exios::BufferView { body.data(), body.size() },
+    };
+
+    std::size_t read = 0;
+
+    acceptor.accept(target, [&](auto const& result) {
+        EXPECT(result);
+        target.read_some(in, [&](exios::IoResult r) {
+            EXPECT(r);
+            read = r.value();
+        });
+    });
+
+    client.connect("test"sv, [&](auto const& result) {
+        EXPECT(result);
+        client.write_some(out, [&](exios::IoResult r) {
+            EXPECT(r);
+            EXPECT(r.value() == kHeader.size() + kBody.size());
+        });
+    });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(read == kHeader.size() + kBody.size());
+    EXPECT(std::string_view(header.data(), header.size()) == kHeader);
+    EXPECT(std::string_view(body.data(), read - header.size()) == kBody);
+}
+
+auto should_transfer_whole_buffers() -> void
+{
+    constexpr std::size_t kSize = 4 * 1024 * 1024;
+
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "test"sv };
+    exios::UnixSocket client { thread };
+    exios::UnixSocket target { thread };
+
+    std::vector<char> out(kSize);
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i] = static_cast<char>(i % 251);
+
+    std::vector<char> in(kSize);
+    std::size_t reads = 0;
+    std::size_t writes = 0;
+
+    acceptor.accept(target, [&](auto const& result) {
+        EXPECT(result);
+        target.read_exactly(exios::BufferView { in.data(), in.size() },
+                            [&](exios::IoResult r) {
+                                EXPECT(r);
+                                EXPECT(r.value() == kSize);
+                                reads += 1;
+                            });
+    });
+
+    client.connect("test"sv, [&](auto const& result) {
+        EXPECT(result);
+        client.write_all(exios::ConstBufferView { out.data(), out.size() },
+                         [&](exios::IoResult r) {
+                             EXPECT(r);
+                             EXPECT(r.value() == kSize);
+                             writes += 1;
+                         });
+    });
+
+    static_cast<void>(thread.run());
+
+    /* Each transfer needs many partial reads and writes, but completes
+     * once...
+     */
+    EXPECT(reads == 1);
+    EXPECT(writes == 1);
+    EXPECT(in == out);
+}
+
+auto should_transfer_file() -> void
+{
+    constexpr std::size_t kSize = 2 * 1024 * 1024;
+    constexpr std::size_t kOffset = 1000;
+
+    auto const file = ::memfd_create("exios_transfer_file", MFD_CLOEXEC);
+    EXPECT(file >= 0);
+
+    std::vector<char> contents(kSize);
+    for (std::size_t i = 0; i < contents.size(); ++i)
+        contents[i] = static_cast<char>(i % 251);
+    EXPECT(::write(file, contents.data(), contents.size()) ==
+           static_cast<ssize_t>(kSize));
+
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "test"sv };
+    exios::UnixSocket client { thread };
+    exios::UnixSocket target { thread };
+
+    std::vector<char> in(kSize - kOffset);
+    std::size_t sent = 0;
+    std::size_t received = 0;
+
+    acceptor.accept(target, [&](auto const& result) {
+        EXPECT(result);
+        target.read_exactly(exios::BufferView { in.data(), in.size() },
+                            [&](exios::IoResult r) {
+                                EXPECT(r);
+                                received = r.value();
+                            });
+    });
+
+    /* The range runs past the end of the file, so the transfer is
+     * short...
+     */
+    client.connect("test"sv, [&](auto const& result) {
+        EXPECT(result);
+        client.transfer_file(file, kOffset, kSize, [&](exios::IoResult r) {
+            EXPECT(r);
+            sent = r.value();
+        });
+    });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(sent == kSize - kOffset);
+    EXPECT(received == kSize - kOffset);
+    EXPECT(std::equal(in.begin(), in.end(), contents.begin() + kOffset));
+
+    /* The file's own offset is left alone...
+     */
+    EXPECT(::lseek(file, 0, SEEK_CUR) == static_cast<off_t>(kSize));
+    ::close(file);
+}
+
+auto should_complete_short_read_when_cancelled() -> void
+{
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "test"sv };
+    exios::UnixSocket client { thread };
+    exios::UnixSocket target { thread };
+
+    std::array<char, 2> const out { 'a', 'b' };
+    std::array<char, 4> in {};
+    std::size_t received = 0;
+
+    acceptor.accept(target, [](auto const& result) { EXPECT(result); });
+    client.connect("test"sv, [](auto const& result) { EXPECT(result); });
+    static_cast<void>(thread.run());
+
+    /* Half of the buffer is read straight away, and the rest is waited
+     * for until the cancellation...
+     */
+    client.write(exios::ConstBufferView { out.data(), out.size() },
+                 [&](exios::IoResult r) {
+                     EXPECT(r);
+                     target.read_exactly(
+                         exios::BufferView { in.data(), in.size() },
+                         [&](exios::IoResult result) {
+                             EXPECT(result);
+                             received = result.value();
+                         });
+                     target.cancel();
+                 });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(received == out.size());
+    EXPECT(std::equal(out.begin(), out.end(), in.begin()));
+}
+
+auto should_complete_short_write_on_error() -> void
+{
+    constexpr std::size_t kSize = 4 * 1024 * 1024;
+
+    /* Writing to the closed peer would otherwise kill us...
+     */
+    ::signal(SIGPIPE, SIG_IGN);
+
+    exios::ContextThread thread;
+    exios::UnixSocketAcceptor acceptor { thread, "test"sv };
+    exios::UnixSocket client { thread };
+    exios::UnixSocket target { thread };
+
+    std::vector<char> out(kSize);
+    std::size_t written = 0;
+    bool failed = false;
+
+    acceptor.accept(target, [&](auto const& result) {
+        EXPECT(result);
+
+        /* The write fills the socket's buffer, and waits for the rest
+         * to drain; Which it never will...
+         */
+        client.write_all(
+            exios::ConstBufferView { out.data(), out.size() },
+            [&](exios::IoResult r) {
+                EXPECT(r);
+                written = r.value();
+
+                /* The error is left for the next write...
+                 */
+                client.write(exios::ConstBufferView { out.data(), 1 },
+                             [&](exios::IoResult next) {
+                                 failed = !next &&
+                                          next.error() ==
+                                              std::errc::broken_pipe;
+                             });
+            });
+        target.close();
+    });
+    client.connect("test"sv, [](auto const& result) { EXPECT(result); });
+
+    static_cast<void>(thread.run());
+
+    EXPECT(written > 0);
+    EXPECT(written < kSize);
+    EXPECT(failed);
+}
+
 auto main() -> int
 {
     return testing::run({ TEST(should_construct_unix_socket),
                           TEST(should_construct_unix_socket_acceptor),
                           TEST(should_connect_and_accept),
                           TEST(should_send_and_receive),
-                          TEST(should_transfer_file_descriptors) });
+                          TEST(should_exchange_messages_persistently),
+                          TEST(should_not_overtake_pending_reads),
+                          TEST(should_transfer_file_descriptors),
+                          TEST(should_scatter_and_gather),
+                          TEST(should_transfer_whole_buffers),
+                          TEST(should_transfer_file),
+                          TEST(should_complete_short_read_when_cancelled),
+                          TEST(should_complete_short_write_on_error) });
 }